@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+// Offline host for EssentiaPluginAudioProcessor. Configures the meter units and the
+// channel layout through the public processor API, drives processBlock() with fixed
+// and mixed block sizes and reports the per-block latency distribution.
+//
+// usage: essentialight_host_benchmark [--sample-rate SR] [--seconds S] [--units RMS,POWER,LOUDNESS]
+//                                     [--check-realtime] [--trace FILE] [--format json|csv] [--out FILE]
+//
+// --trace writes the spans of the last blocks as Chrome trace JSON.
+// --check-realtime reports every allocation or mutex lock made inside processBlock()
+// (after the untimed first block), with its call stack, and exits with 2 if there was any.
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "StringUtils.h"
+#include "ofxAABenchmarkUtils.h"
+#include "ofxAARealtimeChecker.h"
+
+using namespace ofxaa::benchmark;
+
+static const int blockSizes[] = { 37, 64, 128, 256, 512, 1024, 4096 };
+static const int mixedBlockSizes[] = { 64, 37, 512, 4096, 128, 1, 1024, 256, 333 };
+
+struct Options {
+    double sampleRate = 48000;
+    double seconds = 10.0;
+    juce::StringArray units { "RMS", "POWER", "LOUDNESS" };
+    bool checkRealtime = false;
+    std::string tracePath;
+    CommonOptions common;
+};
+
+//MARK: - Processor setup
+
+static juce::RangedAudioParameter* findParameter(juce::AudioProcessor& processor, const juce::String& parameterID){
+    for (auto* parameter : processor.getParameters()){
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter)){
+            if (ranged->paramID == parameterID){
+                return ranged;
+            }
+        }
+    }
+    return nullptr;
+}
+
+///Sets the algorithm type of the meter units in order, the remaining units are set to none.
+static bool configureUnits(juce::AudioProcessor& processor, const juce::StringArray& units){
+    for (int idx=0; ; idx++){
+        auto* choice = dynamic_cast<juce::AudioParameterChoice*>(findParameter(processor, IDs::IDwithIdx(IDs::algorithmType, idx)));
+        if (choice == nullptr){
+            return idx >= units.size();
+        }
+        int index = 0;
+        if (idx < units.size()){
+            index = choice->choices.indexOf(units[idx]);
+            if (index < 0){
+                std::cerr << "Unknown meter type: " << units[idx] << std::endl;
+                return false;
+            }
+        }
+        *choice = index;
+    }
+}
+
+static bool setChannels(juce::AudioProcessor& processor, int numChannels){
+    auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    return processor.setBusesLayout(layout);
+}
+
+//MARK: - Measurement
+
+static void fillWithTone(juce::AudioBuffer<float>& buffer, double sampleRate){
+    for (int channel=0; channel<buffer.getNumChannels(); channel++){
+        auto* data = buffer.getWritePointer(channel);
+        for (int i=0; i<buffer.getNumSamples(); i++){
+            data[i] = 0.3f * std::sin(2.0 * juce::MathConstants<double>::pi * 220.0 * i / sampleRate);
+        }
+    }
+}
+
+///Runs processBlock over `seconds` of audio with the given block sizes, cycling through them.
+static Record run(EssentiaPluginAudioProcessor& processor, const Options& options, int numChannels,
+                  const juce::String& name, const std::vector<int>& sizes){
+    int maxBlockSize = *std::max_element(sizes.begin(), sizes.end());
+    
+    Record record;
+    record.set("scenario", name.toStdString())
+          .set("channels", numChannels)
+          .set("units", options.units.joinIntoString(",").toStdString())
+          .set("sampleRate", options.sampleRate);
+    
+    if (!setChannels(processor, numChannels)){
+        return record.set("status", "channel layout not supported");
+    }
+    processor.setRateAndBufferSizeDetails(options.sampleRate, maxBlockSize);
+    processor.prepareToPlay(options.sampleRate, maxBlockSize);
+    
+    juce::AudioBuffer<float> buffer(numChannels, maxBlockSize);
+    juce::MidiBuffer midi;
+    
+    int64_t totalSamples = int64_t(options.seconds * options.sampleRate);
+    int minBlockSize = *std::min_element(sizes.begin(), sizes.end());
+    std::vector<double> durations;
+    ///reserved up front, so growing it doesn't show up as allocations of processBlock
+    durations.reserve(size_t(totalSamples / minBlockSize + 1));
+    double audioNanoseconds = 0.0;
+    
+    ///one untimed pass so the first allocations of the processor are not in the numbers
+    fillWithTone(buffer, options.sampleRate);
+    processor.processBlock(buffer, midi);
+    
+    realtime::resetViolations();
+    auto allocationsBefore = allocationCount();
+    size_t next = 0;
+    for (int64_t processed = 0; processed < totalSamples; ){
+        int blockSize = sizes[next++ % sizes.size()];
+        buffer.setSize(numChannels, blockSize, true, false, true);
+        fillWithTone(buffer, options.sampleRate);
+        
+        auto start = nowNanoseconds();
+        if (options.checkRealtime){
+            realtime::ScopedRealtimeSection section;
+            processor.processBlock(buffer, midi);
+        } else {
+            processor.processBlock(buffer, midi);
+        }
+        durations.push_back(double(nowNanoseconds() - start));
+        
+        audioNanoseconds += 1.0e9 * blockSize / options.sampleRate;
+        processed += blockSize;
+    }
+    auto allocations = allocationCount() - allocationsBefore;
+    auto governorState = processor.getGovernor().getState();
+    
+    processor.releaseResources();
+    
+    if (options.checkRealtime){
+        record.set("realtimeViolations", int64_t(realtime::getViolationsCount()));
+        if (realtime::getViolationsCount() > 0){
+            std::cerr << "== " << numChannels << " ch, " << name << std::endl;
+            realtime::reportViolations(std::cerr);
+        }
+    }
+    
+    double total = 0.0;
+    for (auto d : durations) total += d;
+    double mean = total / durations.size();
+    double meanBlockNanoseconds = audioNanoseconds / durations.size();
+    double p50 = percentile(durations, 50);
+    double p99 = percentile(durations, 99);
+    double max = durations.back(); ///sorted by percentile()
+    
+    return record.set("status", "ok")
+                 .set("blocks", (int64_t)durations.size())
+                 .set("blockNs", meanBlockNanoseconds)
+                 .set("meanNs", mean)
+                 .set("p50Ns", p50)
+                 .set("p99Ns", p99)
+                 .set("maxNs", max)
+                 .set("allocationsPerBlock", double(allocations) / durations.size())
+                 .set("governorLevel", governorState.level)
+                 .set("cpuLoad", mean / meanBlockNanoseconds)
+                 ///How many instances fit on one core if every block has to finish in time at p99
+                 .set("instancesPerCoreP99", p99 > 0 ? std::floor(meanBlockNanoseconds / p99) : 0.0)
+                 .set("instancesPerCoreMean", mean > 0 ? std::floor(meanBlockNanoseconds / mean) : 0.0);
+}
+
+//MARK: - Main
+
+static void printUsage(){
+    std::cerr << "usage: essentialight_host_benchmark [--sample-rate SR] [--seconds S] [--units RMS,POWER,LOUDNESS]"
+                 " [--check-realtime] [--trace FILE] [--format json|csv] [--out FILE]" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+    std::vector<std::string> args(argv + 1, argv + argc);
+    Options options;
+    if (!parseCommonOptions(args, options.common)){
+        printUsage();
+        return 1;
+    }
+    for (size_t i=0; i<args.size(); i++){
+        if (args[i] == "--sample-rate" && i + 1 < args.size()){
+            options.sampleRate = std::atof(args[++i].c_str());
+        } else if (args[i] == "--seconds" && i + 1 < args.size()){
+            options.seconds = std::atof(args[++i].c_str());
+        } else if (args[i] == "--units" && i + 1 < args.size()){
+            options.units = juce::StringArray::fromTokens(juce::String(args[++i]), ",", "");
+            options.units.removeEmptyStrings();
+        } else if (args[i] == "--check-realtime"){
+            options.checkRealtime = true;
+        } else if (args[i] == "--trace" && i + 1 < args.size()){
+            options.tracePath = args[++i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (options.sampleRate <= 0 || options.seconds <= 0){
+        printUsage();
+        return 1;
+    }
+    if (options.checkRealtime && !realtime::isAvailable()){
+        std::cerr << "--check-realtime is not available on this platform" << std::endl;
+        return 1;
+    }
+    
+    ///The processor and its magic state use timers and value trees
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    
+    std::vector<Record> records;
+    {
+        EssentiaPluginAudioProcessor processor;
+        if (!configureUnits(processor, options.units)){
+            return 1;
+        }
+        processor.setTracing(!options.tracePath.empty());
+        
+        for (int numChannels : { 1, 2 }){
+            for (int blockSize : blockSizes){
+                std::cerr << "Running " << numChannels << " ch, " << blockSize << " samples" << std::endl;
+                records.push_back(run(processor, options, numChannels, juce::String(blockSize), { blockSize }));
+            }
+            std::vector<int> mixed(std::begin(mixedBlockSizes), std::end(mixedBlockSizes));
+            records.push_back(run(processor, options, numChannels, "mixed", mixed));
+        }
+        
+        if (!options.tracePath.empty()){
+            auto file = juce::File::getCurrentWorkingDirectory().getChildFile(juce::String(options.tracePath));
+            if (!processor.writeTrace(file)){
+                std::cerr << "Could not write " << options.tracePath << std::endl;
+                return 1;
+            }
+        }
+    }
+    
+    if (!writeRecords(records, options.common)){
+        return 1;
+    }
+    for (auto& record : records){
+        if (record.get("realtimeViolations") != "" && record.get("realtimeViolations") != "0"){
+            return 2;
+        }
+    }
+    return 0;
+}
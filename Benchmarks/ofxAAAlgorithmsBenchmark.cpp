@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+// Cost of every ofxaa::AlgorithmType, of the ofxAA wrapper classes and of the
+// whole Network, for the usual frame sizes and sample rates.
+//
+// usage: ofxaa_benchmark_algorithms [--iterations N] [--filter NAME] [--check-realtime] [--format json|csv] [--out FILE]
+//
+// --check-realtime reports every allocation or mutex lock made by the measured
+// iterations (after warm-up), with its call stack, and exits with 2 if there was any.
+
+#include "ofxAABenchmarkUtils.h"
+#include "ofxAARealtimeChecker.h"
+#include "ofxAAFactory.h"
+#include "ofxAANetwork.h"
+#include "ofxAudioAnalyzer.h"
+#include "ofxAudioAnalyzerAlgorithms.h"
+
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <memory>
+
+using namespace ofxaa::benchmark;
+
+#define HARMONICS_NUM 10
+#define FUNDAMENTAL_FREQUENCY 220.0
+#define PCP_FRAMES_NUM 16
+#define WARMUP_ITERATIONS 10
+
+static const int frameSizes[] = { 256, 512, 1024, 2048, 4096 };
+static const int sampleRates[] = { 44100, 48000, 96000 };
+
+//MARK: - Fixture
+
+///Synthetic inputs for one sample rate / frame size: a harmonic tone with some noise,
+///and the intermediate data the spectral and tonal algorithms expect as input.
+struct Fixture {
+    Fixture(int sampleRate, int frameSize);
+    
+    int sampleRate;
+    int frameSize;
+    
+    Real pitch = FUNDAMENTAL_FREQUENCY;
+    vector<Real> frame;
+    vector<Real> envelope;
+    vector<Real> spectrum;
+    vector<Real> phase;
+    vector<complex<Real>> fft;
+    vector<Real> frequencies;
+    vector<Real> magnitudes;
+    vector<Real> centralMoments;
+    vector<vector<Real>> pcp;
+};
+
+Fixture::Fixture(int sr, int fs) : sampleRate(sr), frameSize(fs) {
+    uint32_t noise = 12345;
+    frame.resize(frameSize);
+    for (int i=0; i<frameSize; i++){
+        Real value = 0.0;
+        for (int h=1; h<=HARMONICS_NUM; h++){
+            value += std::sin(2.0 * M_PI * FUNDAMENTAL_FREQUENCY * h * i / sampleRate) / h;
+        }
+        noise = noise * 1664525u + 1013904223u;
+        value += 0.01 * ((noise >> 8) / float(1 << 24) - 0.5);
+        frame[i] = 0.3 * value;
+    }
+    
+    for (auto s : frame){
+        envelope.push_back(std::abs(s));
+    }
+    
+    auto fftAlgorithm = ofxaa::createAlgorithmWithType(ofxaa::Fft, sampleRate, frameSize);
+    fftAlgorithm->input("frame").set(frame);
+    fftAlgorithm->output("fft").set(fft);
+    fftAlgorithm->compute();
+    delete fftAlgorithm;
+    
+    for (auto& bin : fft){
+        spectrum.push_back(std::abs(bin));
+        phase.push_back(std::arg(bin));
+    }
+    
+    for (int h=1; h<=HARMONICS_NUM; h++){
+        frequencies.push_back(FUNDAMENTAL_FREQUENCY * h);
+        magnitudes.push_back(1.0 / h);
+    }
+    
+    auto moments = ofxaa::createAlgorithmWithType(ofxaa::CentralMoments, sampleRate, frameSize);
+    moments->input("array").set(spectrum);
+    moments->output("centralMoments").set(centralMoments);
+    moments->compute();
+    delete moments;
+    
+    vector<Real> chroma(12, 0.1);
+    chroma[0] = chroma[4] = chroma[7] = 1.0;
+    pcp.assign(PCP_FRAMES_NUM, chroma);
+}
+
+//MARK: - Binding
+
+///Owns the output buffers of one algorithm.
+struct Outputs {
+    vector<std::shared_ptr<void>> buffers;
+    
+    template <typename T>
+    void bind(Algorithm* algorithm, const string& name){
+        auto buffer = std::make_shared<T>();
+        algorithm->output(name).set(*buffer);
+        buffers.push_back(buffer);
+    }
+};
+
+///Connects the inputs of the algorithm to the fixture data, by name and type.
+///Returns an empty string on success, otherwise the reason why it couldn't be bound.
+static string bindInputs(Algorithm* algorithm, Fixture& fixture){
+    for (auto& name : algorithm->inputNames()){
+        auto& input = algorithm->input(name);
+        auto& type = input.typeInfo();
+        
+        if (type == typeid(vector<Real>)){
+            if (name == "frame" || name == "signal" || name == "array"){
+                input.set(fixture.frame);
+            } else if (name == "envelope"){
+                input.set(fixture.envelope);
+            } else if (name == "spectrum"){
+                input.set(fixture.spectrum);
+            } else if (name == "phase"){
+                input.set(fixture.phase);
+            } else if (name == "frequencies"){
+                input.set(fixture.frequencies);
+            } else if (name == "magnitudes"){
+                input.set(fixture.magnitudes);
+            } else if (name == "centralMoments"){
+                input.set(fixture.centralMoments);
+            } else {
+                return "no fixture for input " + name;
+            }
+        } else if (type == typeid(Real) && name == "pitch"){
+            input.set(fixture.pitch);
+        } else if (type == typeid(vector<complex<Real>>)){
+            input.set(fixture.fft);
+        } else if (type == typeid(vector<vector<Real>>) && name == "pcp"){
+            input.set(fixture.pcp);
+        } else {
+            return "no fixture for input " + name + " of type " + nameOfType(type);
+        }
+    }
+    return "";
+}
+
+static string bindOutputs(Algorithm* algorithm, Outputs& outputs){
+    for (auto& name : algorithm->outputNames()){
+        auto& type = algorithm->output(name).typeInfo();
+        
+        if (type == typeid(Real)){
+            outputs.bind<Real>(algorithm, name);
+        } else if (type == typeid(int)){
+            outputs.bind<int>(algorithm, name);
+        } else if (type == typeid(string)){
+            outputs.bind<string>(algorithm, name);
+        } else if (type == typeid(vector<Real>)){
+            outputs.bind<vector<Real>>(algorithm, name);
+        } else if (type == typeid(vector<string>)){
+            outputs.bind<vector<string>>(algorithm, name);
+        } else if (type == typeid(vector<complex<Real>>)){
+            outputs.bind<vector<complex<Real>>>(algorithm, name);
+        } else if (type == typeid(vector<vector<Real>>)){
+            outputs.bind<vector<vector<Real>>>(algorithm, name);
+        } else if (type == typeid(vector<vector<complex<Real>>>)){
+            outputs.bind<vector<vector<complex<Real>>>>(algorithm, name);
+        } else {
+            return "unsupported output " + name + " of type " + nameOfType(type);
+        }
+    }
+    return "";
+}
+
+//MARK: - Measurement
+
+struct Options {
+    int iterations = 200;
+    string filter;
+    bool checkRealtime = false;
+    CommonOptions common;
+};
+
+///Set when a case violated realtime safety with --check-realtime.
+static bool foundRealtimeViolations = false;
+
+///Runs the body WARMUP_ITERATIONS + iterations times and fills the record with the timings
+///of the measured iterations. Exceptions thrown by the body end up in the status column.
+static void measure(Record& record, const Fixture& fixture, const Options& options, const std::function<void()>& body){
+    int iterations = options.iterations;
+    vector<double> durations;
+    durations.reserve(iterations);
+    
+    try {
+        for (int i=0; i<WARMUP_ITERATIONS; i++){
+            body();
+        }
+        realtime::resetViolations();
+        auto allocationsBefore = allocationCount();
+        for (int i=0; i<iterations; i++){
+            auto start = nowNanoseconds();
+            if (options.checkRealtime){
+                realtime::ScopedRealtimeSection section;
+                body();
+            } else {
+                body();
+            }
+            durations.push_back(double(nowNanoseconds() - start));
+        }
+        auto allocationsAfter = allocationCount();
+        
+        if (options.checkRealtime){
+            record.set("realtimeViolations", int64_t(realtime::getViolationsCount()));
+            if (realtime::getViolationsCount() > 0){
+                foundRealtimeViolations = true;
+                std::cerr << "== " << record.get("name") << " @ " << fixture.sampleRate << " Hz, " << fixture.frameSize << " samples" << std::endl;
+                realtime::reportViolations(std::cerr);
+            }
+        }
+        
+        double total = 0.0;
+        for (auto d : durations) total += d;
+        double mean = total / iterations;
+        double frameDuration = 1.0e9 * fixture.frameSize / fixture.sampleRate;
+        
+        record.set("status", "ok")
+              .set("nsPerFrame", mean)
+              .set("nsMedian", percentile(durations, 50))
+              .set("nsP99", percentile(durations, 99))
+              .set("allocationsPerFrame", double(allocationsAfter - allocationsBefore) / iterations)
+              .set("realtimeFactor", mean > 0 ? frameDuration / mean : 0.0);
+    } catch (const std::exception& e){
+        record.set("status", string("error: ") + e.what());
+    }
+}
+
+static Record makeRecord(const string& name, const string& kind, const Fixture& fixture){
+    Record record;
+    record.set("name", name)
+          .set("kind", kind)
+          .set("sampleRate", fixture.sampleRate)
+          .set("frameSize", fixture.frameSize);
+    return record;
+}
+
+static bool matchesFilter(const Options& options, const string& name){
+    return options.filter.empty() || name.find(options.filter) != string::npos;
+}
+
+//MARK: - Cases
+
+static void benchmarkAlgorithmTypes(Fixture& fixture, const Options& options, vector<Record>& records){
+    for (int t=0; t<ofxaa::AlgorithmTypesNum; t++){
+        auto type = static_cast<ofxaa::AlgorithmType>(t);
+        string name = ofxaa::algorithmTypeToString(type);
+        if (!matchesFilter(options, name)) continue;
+        
+        auto record = makeRecord(name, "algorithm", fixture);
+        
+        std::unique_ptr<Algorithm> algorithm;
+        try {
+            algorithm.reset(ofxaa::createAlgorithmWithType(type, fixture.sampleRate, fixture.frameSize));
+        } catch (const std::exception& e){
+            records.push_back(record.set("status", string("error: ") + e.what()));
+            continue;
+        }
+        if (algorithm == nullptr){
+            ///Composite types like Onsets have no single Essentia algorithm
+            records.push_back(record.set("status", "not created by createAlgorithmWithType"));
+            continue;
+        }
+        
+        Outputs outputs;
+        auto reason = bindInputs(algorithm.get(), fixture);
+        if (reason.empty()){
+            reason = bindOutputs(algorithm.get(), outputs);
+        }
+        if (!reason.empty()){
+            records.push_back(record.set("status", "skipped: " + reason));
+            continue;
+        }
+        
+        measure(record, fixture, options, [&]{ algorithm->compute(); });
+        records.push_back(record);
+    }
+}
+
+static void benchmarkWrappers(Fixture& fixture, const Options& options, vector<Record>& records){
+    int sr = fixture.sampleRate;
+    int fs = fixture.frameSize;
+    
+    if (matchesFilter(options, "ofxAASingleOutputAlgorithm")){
+        ofxAASingleOutputAlgorithm rms(ofxaa::Rms, sr, fs);
+        rms.hasLogarithmicValues = true;
+        rms.algorithm->input("array").set(fixture.frame);
+        rms.algorithm->output("rms").set(rms.outputValue);
+        
+        auto record = makeRecord("ofxAASingleOutputAlgorithm(RMS)", "wrapper", fixture);
+        measure(record, fixture, options, [&]{
+            rms.compute();
+            rms.getValue(0.5, true);
+        });
+        records.push_back(record);
+        rms.deleteAlgorithm();
+    }
+    
+    if (matchesFilter(options, "ofxAAOneVectorOutputAlgorithm")){
+        ofxAAOneVectorOutputAlgorithm spectrum(ofxaa::Spectrum, sr, fs, (fs/2)+1);
+        spectrum.algorithm->input("frame").set(fixture.frame);
+        spectrum.algorithm->output("spectrum").set(spectrum.outputValues);
+        
+        auto record = makeRecord("ofxAAOneVectorOutputAlgorithm(Spectrum)", "wrapper", fixture);
+        measure(record, fixture, options, [&]{
+            spectrum.compute();
+            spectrum.getValues(0.5, true);
+        });
+        records.push_back(record);
+        spectrum.deleteAlgorithm();
+    }
+    
+    if (matchesFilter(options, "ofxaa::Network")){
+        ofxaa::Network network(sr, fs);
+        auto record = makeRecord("ofxaa::Network", "network", fixture);
+        measure(record, fixture, options, [&]{ network.computeAlgorithms(fixture.frame, (int)fixture.frame.size()); });
+        records.push_back(record);
+    }
+    
+    if (matchesFilter(options, "ofxAudioAnalyzer")){
+        ofxAudioAnalyzer analyzer;
+        analyzer.setup(sr, fs, 1);
+        analyzer.subscribe(RMS, 0.5);
+        analyzer.subscribe(POWER, 0.5);
+        analyzer.subscribe(LOUDNESS, 0.5);
+        
+        const float* channels[] = { fixture.frame.data() };
+        auto record = makeRecord("ofxAudioAnalyzer::analyze", "analyzer", fixture);
+        measure(record, fixture, options, [&]{ analyzer.analyze(channels, 1, fs); });
+        records.push_back(record);
+    }
+}
+
+//MARK: - Main
+
+static void printUsage(){
+    std::cerr << "usage: ofxaa_benchmark_algorithms [--iterations N] [--filter NAME] [--check-realtime] [--format json|csv] [--out FILE]" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+    vector<string> args(argv + 1, argv + argc);
+    Options options;
+    if (!parseCommonOptions(args, options.common)){
+        printUsage();
+        return 1;
+    }
+    for (size_t i=0; i<args.size(); i++){
+        if (args[i] == "--iterations" && i + 1 < args.size()){
+            options.iterations = std::max(1, std::atoi(args[++i].c_str()));
+        } else if (args[i] == "--filter" && i + 1 < args.size()){
+            options.filter = args[++i];
+        } else if (args[i] == "--check-realtime"){
+            options.checkRealtime = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (options.checkRealtime && !realtime::isAvailable()){
+        std::cerr << "--check-realtime is not available on this platform" << std::endl;
+        return 1;
+    }
+    
+    essentia::init();
+    
+    vector<Record> records;
+    for (auto sampleRate : sampleRates){
+        for (auto frameSize : frameSizes){
+            std::cerr << "Benchmarking " << sampleRate << " Hz, " << frameSize << " samples" << std::endl;
+            Fixture fixture(sampleRate, frameSize);
+            benchmarkAlgorithmTypes(fixture, options, records);
+            benchmarkWrappers(fixture, options, records);
+        }
+    }
+    
+    essentia::shutdown();
+    
+    if (!writeRecords(records, options.common)){
+        return 1;
+    }
+    return foundRealtimeViolations ? 2 : 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAABenchmarkUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+//MARK: - Allocation counting
+
+static std::atomic<uint64_t> allocations { 0 };
+
+void* operator new(std::size_t size){
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size){
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace ofxaa { namespace benchmark {
+    
+    uint64_t allocationCount(){
+        return allocations.load(std::memory_order_relaxed);
+    }
+    //----------------------------------------------
+    double percentile(std::vector<double>& samples, double p){
+        if (samples.empty()) return 0.0;
+        std::sort(samples.begin(), samples.end());
+        auto rank = (size_t)std::ceil(p / 100.0 * samples.size());
+        rank = std::min(std::max(rank, (size_t)1), samples.size());
+        return samples[rank - 1];
+    }
+    
+    //MARK: - Records
+    
+    Record& Record::set(const std::string& key, const std::string& value){
+        fields.push_back({key, value, true});
+        return *this;
+    }
+    //----------------------------------------------
+    Record& Record::set(const std::string& key, double value){
+        std::ostringstream out;
+        out.precision(6);
+        out << value;
+        fields.push_back({key, std::isfinite(value) ? out.str() : "null", false});
+        return *this;
+    }
+    //----------------------------------------------
+    Record& Record::set(const std::string& key, int64_t value){
+        fields.push_back({key, std::to_string(value), false});
+        return *this;
+    }
+    //----------------------------------------------
+    std::string Record::get(const std::string& key) const {
+        for (auto& field : fields){
+            if (field.key == key) return field.value;
+        }
+        return "";
+    }
+    //----------------------------------------------
+    static std::string jsonEscaped(const std::string& text){
+        std::string result;
+        for (auto c : text){
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\t': result += "\\t"; break;
+                default: result += c;
+            }
+        }
+        return result;
+    }
+    //----------------------------------------------
+    static std::string csvEscaped(const std::string& text){
+        if (text.find_first_of(",\"\n") == std::string::npos){
+            return text;
+        }
+        std::string result = "\"";
+        for (auto c : text){
+            result += c;
+            if (c == '"') result += c;
+        }
+        return result + "\"";
+    }
+    //----------------------------------------------
+    void writeRecords(const std::vector<Record>& records, OutputFormat format, std::ostream& stream){
+        if (format == CSV){
+            if (records.empty()) return;
+            auto& header = records.front().getFields();
+            for (size_t i=0; i<header.size(); i++){
+                stream << (i > 0 ? "," : "") << csvEscaped(header[i].key);
+            }
+            stream << "\n";
+            for (auto& record : records){
+                auto& fields = record.getFields();
+                for (size_t i=0; i<fields.size(); i++){
+                    stream << (i > 0 ? "," : "") << (fields[i].value == "null" ? "" : csvEscaped(fields[i].value));
+                }
+                stream << "\n";
+            }
+            return;
+        }
+        
+        stream << "[\n";
+        for (size_t r=0; r<records.size(); r++){
+            stream << "  {";
+            auto& fields = records[r].getFields();
+            for (size_t i=0; i<fields.size(); i++){
+                stream << (i > 0 ? ", " : "") << "\"" << jsonEscaped(fields[i].key) << "\": ";
+                if (fields[i].isString){
+                    stream << "\"" << jsonEscaped(fields[i].value) << "\"";
+                } else {
+                    stream << fields[i].value;
+                }
+            }
+            stream << (r + 1 < records.size() ? "},\n" : "}\n");
+        }
+        stream << "]\n";
+    }
+    //----------------------------------------------
+    bool parseCommonOptions(std::vector<std::string>& args, CommonOptions& options){
+        std::vector<std::string> remaining;
+        for (size_t i=0; i<args.size(); i++){
+            if (args[i] == "--format" && i + 1 < args.size()){
+                auto value = args[++i];
+                if (value == "csv"){
+                    options.format = CSV;
+                } else if (value == "json"){
+                    options.format = JSON;
+                } else {
+                    std::cerr << "Unknown format: " << value << std::endl;
+                    return false;
+                }
+            } else if (args[i] == "--out" && i + 1 < args.size()){
+                options.outputPath = args[++i];
+            } else {
+                remaining.push_back(args[i]);
+            }
+        }
+        args = remaining;
+        return true;
+    }
+    //----------------------------------------------
+    bool writeRecords(const std::vector<Record>& records, const CommonOptions& options){
+        if (options.outputPath.empty()){
+            writeRecords(records, options.format, std::cout);
+            return true;
+        }
+        std::ofstream file(options.outputPath);
+        if (!file){
+            std::cerr << "Can't write " << options.outputPath << std::endl;
+            return false;
+        }
+        writeRecords(records, options.format, file);
+        return true;
+    }
+}}
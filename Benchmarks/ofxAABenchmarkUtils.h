@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+///Helpers shared by the benchmark executables.
+namespace ofxaa { namespace benchmark {
+    
+    ///Number of operator new calls since the program started. Counted by the replacement
+    ///operators in ofxAABenchmarkUtils.cpp, so it includes allocations made inside Essentia.
+    uint64_t allocationCount();
+    
+    inline uint64_t nowNanoseconds(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    ///Percentile (0-100) of unsorted samples, by nearest rank. Sorts the samples.
+    double percentile(std::vector<double>& samples, double p);
+    
+    ///One row of results. Values are written in insertion order.
+    class Record {
+    public:
+        Record& set(const std::string& key, const std::string& value);
+        Record& set(const std::string& key, const char* value){ return set(key, std::string(value)); }
+        Record& set(const std::string& key, double value);
+        Record& set(const std::string& key, int64_t value);
+        Record& set(const std::string& key, int value){ return set(key, (int64_t)value); }
+        
+        struct Field {
+            std::string key;
+            std::string value;
+            bool isString;
+        };
+        const std::vector<Field>& getFields() const { return fields; }
+        ///Value of key as written to the output, empty if not set.
+        std::string get(const std::string& key) const;
+        
+    private:
+        std::vector<Field> fields;
+    };
+    
+    enum OutputFormat {
+        JSON,
+        CSV
+    };
+    
+    ///Writes records as a JSON array of objects or as CSV with the keys of the first record as header.
+    void writeRecords(const std::vector<Record>& records, OutputFormat format, std::ostream& stream);
+    
+    ///Parses the options shared by all benchmarks: --format json|csv and --out <file>.
+    ///Returns false if an argument wasn't recognised, consumed arguments are removed from args.
+    struct CommonOptions {
+        OutputFormat format = JSON;
+        std::string outputPath;
+    };
+    bool parseCommonOptions(std::vector<std::string>& args, CommonOptions& options);
+    
+    ///Writes to options.outputPath, or stdout if it is empty.
+    bool writeRecords(const std::vector<Record>& records, const CommonOptions& options);
+}}
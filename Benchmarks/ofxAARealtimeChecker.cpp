@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAARealtimeChecker.h"
+
+#if defined(__GLIBC__)
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <string>
+
+#define MAX_DISTINCT_VIOLATIONS 256
+#define MAX_STACK_FRAMES 32
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* ptr);
+}
+
+namespace {
+
+    enum ViolationKind {
+        MALLOC,
+        CALLOC,
+        REALLOC,
+        FREE,
+        MEMALIGN,
+        MUTEX_LOCK
+    };
+
+    const char* kindToString(ViolationKind kind){
+        switch (kind) {
+            case MALLOC: return "malloc";
+            case CALLOC: return "calloc";
+            case REALLOC: return "realloc";
+            case FREE: return "free";
+            case MEMALIGN: return "aligned allocation";
+            case MUTEX_LOCK: return "pthread_mutex_lock";
+        }
+        return "";
+    }
+
+    ///Preallocated, so recording never allocates.
+    struct Violation {
+        ViolationKind kind;
+        int numFrames;
+        void* frames[MAX_STACK_FRAMES];
+        std::atomic<uint64_t> count;
+    };
+
+    Violation violations[MAX_DISTINCT_VIOLATIONS];
+    std::atomic<int> numViolations { 0 };
+    std::atomic<uint64_t> totalViolations { 0 };
+
+    ///Plain TLS in the executable, safe to use inside malloc.
+    __thread int realtimeDepth = 0;
+    __thread bool isRecording = false;
+
+    ///backtrace() loads libgcc and allocates the first time it's called.
+    struct BacktraceWarmUp {
+        BacktraceWarmUp(){
+            void* frames[2];
+            backtrace(frames, 2);
+        }
+    } backtraceWarmUp;
+
+    typedef int (*LockFunction)(pthread_mutex_t*);
+
+    ///Constant-initialized, so it's valid before any constructor runs.
+    std::atomic<LockFunction> realMutexLock { nullptr };
+
+    LockFunction resolveMutexLock(){
+        auto lock = (LockFunction)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        realMutexLock.store(lock, std::memory_order_release);
+        return lock;
+    }
+
+    ///dlsym() locks and may allocate, resolve it at load time rather than inside a realtime section.
+    struct MutexLockResolver {
+        MutexLockResolver(){
+            resolveMutexLock();
+        }
+    } mutexLockResolver;
+
+    void record(ViolationKind kind){
+        if (realtimeDepth == 0 || isRecording) return;
+        isRecording = true;
+
+        totalViolations.fetch_add(1, std::memory_order_relaxed);
+
+        void* frames[MAX_STACK_FRAMES];
+        ///skip record() and the interposed function
+        int numFrames = backtrace(frames, MAX_STACK_FRAMES);
+        int skipped = std::min(numFrames, 2);
+
+        int size = std::min(numViolations.load(), MAX_DISTINCT_VIOLATIONS);
+        for (int i=0; i<size; i++){
+            auto& v = violations[i];
+            if (v.kind == kind && v.numFrames == numFrames - skipped
+                && std::memcmp(v.frames, frames + skipped, sizeof(void*) * v.numFrames) == 0){
+                v.count.fetch_add(1, std::memory_order_relaxed);
+                isRecording = false;
+                return;
+            }
+        }
+
+        int index = numViolations.fetch_add(1);
+        if (index < MAX_DISTINCT_VIOLATIONS){
+            auto& v = violations[index];
+            v.kind = kind;
+            v.numFrames = numFrames - skipped;
+            std::memcpy(v.frames, frames + skipped, sizeof(void*) * v.numFrames);
+            v.count.store(1);
+        }
+        isRecording = false;
+    }
+
+    ///"binary(mangled+0x12) [0x...]" -> "binary(demangled+0x12) [0x...]"
+    std::string demangledSymbol(const char* symbol){
+        std::string line = symbol;
+        auto open = line.find('(');
+        auto plus = line.find('+', open);
+        if (open == std::string::npos || plus == std::string::npos || plus == open + 1){
+            return line;
+        }
+        auto mangled = line.substr(open + 1, plus - open - 1);
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+        if (status != 0 || demangled == nullptr){
+            return line;
+        }
+        line = line.substr(0, open + 1) + demangled + line.substr(plus);
+        std::free(demangled);
+        return line;
+    }
+}
+
+//MARK: - Interposed functions
+
+extern "C" {
+
+    void* malloc(size_t size){
+        record(MALLOC);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size){
+        record(CALLOC);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size){
+        record(REALLOC);
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void* ptr){
+        if (ptr != nullptr){
+            record(FREE);
+        }
+        __libc_free(ptr);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size){
+        record(MEMALIGN);
+        void* ptr = __libc_memalign(alignment, size);
+        if (ptr == nullptr){
+            return ENOMEM;
+        }
+        *result = ptr;
+        return 0;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size){
+        record(MEMALIGN);
+        return __libc_memalign(alignment, size);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex){
+        auto realLock = realMutexLock.load(std::memory_order_acquire);
+        ///only locks taken by other constructors before ours get here
+        if (realLock == nullptr){
+            realLock = resolveMutexLock();
+        }
+        record(MUTEX_LOCK);
+        return realLock(mutex);
+    }
+}
+
+//MARK: - API
+
+namespace ofxaa { namespace benchmark { namespace realtime {
+
+    bool isAvailable(){
+        return true;
+    }
+
+    ScopedRealtimeSection::ScopedRealtimeSection(){
+        realtimeDepth++;
+    }
+
+    ScopedRealtimeSection::~ScopedRealtimeSection(){
+        realtimeDepth--;
+    }
+
+    uint64_t getViolationsCount(){
+        return totalViolations.load();
+    }
+
+    int getDistinctViolationsCount(){
+        return std::min(numViolations.load(), MAX_DISTINCT_VIOLATIONS);
+    }
+
+    void resetViolations(){
+        numViolations.store(0);
+        totalViolations.store(0);
+    }
+
+    void reportViolations(std::ostream& stream){
+        int size = getDistinctViolationsCount();
+        for (int i=0; i<size; i++){
+            auto& v = violations[i];
+            stream << "Realtime violation: " << kindToString(v.kind) << " (" << v.count.load() << "x)\n";
+            char** symbols = backtrace_symbols(v.frames, v.numFrames);
+            for (int f=0; f<v.numFrames; f++){
+                stream << "    #" << f << " " << (symbols != nullptr ? demangledSymbol(symbols[f]) : "?") << "\n";
+            }
+            std::free(symbols);
+        }
+        if (numViolations.load() > MAX_DISTINCT_VIOLATIONS){
+            stream << "... " << numViolations.load() - MAX_DISTINCT_VIOLATIONS << " more call stacks not recorded\n";
+        }
+        stream.flush();
+    }
+}}}
+
+#else
+
+namespace ofxaa { namespace benchmark { namespace realtime {
+
+    bool isAvailable(){ return false; }
+    ScopedRealtimeSection::ScopedRealtimeSection(){}
+    ScopedRealtimeSection::~ScopedRealtimeSection(){}
+    uint64_t getViolationsCount(){ return 0; }
+    int getDistinctViolationsCount(){ return 0; }
+    void resetViolations(){}
+    void reportViolations(std::ostream&){}
+}}}
+
+#endif
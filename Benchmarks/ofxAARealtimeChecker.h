@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+///Catches realtime violations (heap allocations, mutex locks) inside code marked with
+///ScopedRealtimeSection. malloc, calloc, realloc, free, posix_memalign, aligned_alloc and
+///pthread_mutex_lock are interposed by ofxAARealtimeChecker.cpp when it's linked into
+///the executable. Each distinct call stack is recorded once, with a count.
+///
+///Only available with glibc, elsewhere nothing is reported and isAvailable() is false.
+namespace ofxaa { namespace benchmark { namespace realtime {
+
+    bool isAvailable();
+
+    ///Marks the current thread as realtime until destroyed. Sections can be nested.
+    class ScopedRealtimeSection {
+    public:
+        ScopedRealtimeSection();
+        ~ScopedRealtimeSection();
+
+        ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+        ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+    };
+
+    ///Number of violations since the last reset, counting repeats of the same stack.
+    uint64_t getViolationsCount();
+
+    ///Number of distinct call stacks recorded since the last reset.
+    int getDistinctViolationsCount();
+
+    ///Call outside of realtime sections.
+    void resetViolations();
+
+    ///Writes every distinct violation with its count and symbolized call stack.
+    ///Call outside of realtime sections, it allocates.
+    void reportViolations(std::ostream& stream);
+}}}
@@ -8,13 +8,6 @@
 #include "MeterUnit.h"
 #include "StringUtils.h"
 
-vector<ofxAAValue> availableValuesList {
-    ///*** LIGHT
-    RMS,
-    POWER,
-    LOUDNESS
-};
-
 MeterUnit::MeterUnit(int idx) {
     _idx = idx;
     
@@ -23,6 +16,10 @@ MeterUnit::MeterUnit(int idx) {
     smoothingId = IDs::IDwithIdx(IDs::smoothing, _idx);
     resetMaxId = IDs::IDwithIdx(IDs::resetMax, _idx);
     maxEstimatedId = IDs::IDwithIdx(IDs::maxEstimated, _idx);
+    normalizationId = IDs::IDwithIdx(IDs::normalization, _idx);
+    adaptationTimeId = IDs::IDwithIdx(IDs::adaptationTime, _idx);
+    statisticsId = IDs::IDwithIdx(IDs::statistics, _idx);
+    resetStatisticsId = IDs::IDwithIdx(IDs::resetStatistics, _idx);
     outputMeterId = IDs::IDwithIdx(IDs::outputMeter, _idx);
     historyPlotId = IDs::IDwithIdx(IDs::historyPlot, _idx);
 }
@@ -39,18 +36,25 @@ void MeterUnit::setup(foleys::MagicProcessorState* magicState, juce::AudioProces
     
     smoothing = treeState->getRawParameterValue (smoothingId);
     jassert (smoothing != nullptr);
+    normalization = treeState->getRawParameterValue (normalizationId);
+    adaptationTime = treeState->getRawParameterValue (adaptationTimeId);
+    jassert (normalization != nullptr && adaptationTime != nullptr);
     
     treeState->addParameterListener (algorithmTypeId, this);
     treeState->addParameterListener (smoothingId, this);
     treeState->addParameterListener (resetMaxId, this);
     treeState->addParameterListener (maxEstimatedId, this);
+    treeState->addParameterListener (normalizationId, this);
+    treeState->addParameterListener (adaptationTimeId, this);
+    treeState->addParameterListener (statisticsId, this);
+    treeState->addParameterListener (resetStatisticsId, this);
 }
 
 unique_ptr<juce::AudioProcessorParameterGroup> MeterUnit::getParameterGroup() {
     auto generator = std::make_unique<juce::AudioProcessorParameterGroup>(meterId, TRANS (meterId), "|");
     
     auto options = juce::StringArray ("-NONE-");
-    for (auto ofxaaValue : availableValuesList) {
+    for (auto ofxaaValue : utils::availableValuesList) {
         auto name = utils::valueTypeToString(ofxaaValue);
         options.add(name);
     }
@@ -59,11 +63,19 @@ unique_ptr<juce::AudioProcessorParameterGroup> MeterUnit::getParameterGroup() {
     string smoothingParameterName = "Smoothing:" + std::to_string(_idx+1);
     string maxEstimatedParameterName = "MaxEstimated:" + std::to_string(_idx+1);
     string resetMaxParameterName = "ResetMax:" + std::to_string(_idx+1);
+    string normalizationParameterName = "Normalization:" + std::to_string(_idx+1);
+    string adaptationTimeParameterName = "AdaptationTime:" + std::to_string(_idx+1);
+    string statisticsParameterName = "Statistics:" + std::to_string(_idx+1);
+    string resetStatisticsParameterName = "ResetStatistics:" + std::to_string(_idx+1);
     
     generator->addChild (std::make_unique<juce::AudioParameterChoice>(algorithmTypeId, typeParameterName, options, 0),
                          std::make_unique<juce::AudioParameterFloat>(smoothingId, smoothingParameterName, juce::NormalisableRange<float>(0.0, 1.0, 0.01), 0.0f),
                          std::make_unique<juce::AudioParameterFloat>(maxEstimatedId, maxEstimatedParameterName, juce::NormalisableRange<float>(0.0, 100000.0, 0.01), 1.0f),
-                         std::make_unique<juce::AudioParameterBool>(resetMaxId, resetMaxParameterName, true));
+                         std::make_unique<juce::AudioParameterBool>(resetMaxId, resetMaxParameterName, true),
+                         std::make_unique<juce::AudioParameterChoice>(normalizationId, normalizationParameterName, juce::StringArray ("Max Estimated", "Adaptive p5-p95"), 0),
+                         std::make_unique<juce::AudioParameterFloat>(adaptationTimeId, adaptationTimeParameterName, juce::NormalisableRange<float>(1.0, 600.0, 1.0, 0.3), ADAPTIVE_NORMALIZATION_SECONDS),
+                         std::make_unique<juce::AudioParameterBool>(statisticsId, statisticsParameterName, false),
+                         std::make_unique<juce::AudioParameterBool>(resetStatisticsId, resetStatisticsParameterName, true));
     
     return generator;
 }
@@ -71,22 +83,25 @@ unique_ptr<juce::AudioProcessorParameterGroup> MeterUnit::getParameterGroup() {
 void MeterUnit::parameterChanged (const juce::String& param, float value)
 {
     if (param == algorithmTypeId) {
-        if (value == 0) {
-            setOfxaaValue(NONE);
-        } else {
-            int index = value - 1;
-            if (index < availableValuesList.size()) {
-                auto value = availableValuesList[index];
-                setOfxaaValue(value);
-            }
-        }
+        setOfxaaValue(utils::choiceIndexToValueType(value));
     } else if (param == smoothingId) {
+        if (currentOfxaaValue != NONE) {
+            _audioAnalyzer->setSmoothing(currentOfxaaValue, value);
+        }
     } else if (param == resetMaxId) {
         outputMeter->resetMaxValue();
     } else if (param == maxEstimatedId) {
         if (currentOfxaaValue != NONE) {
             _audioAnalyzer->setMaxEstimatedValue(0, currentOfxaaValue, value);
         }
+    } else if (param == normalizationId || param == adaptationTimeId) {
+        applyNormalization();
+    } else if (param == statisticsId) {
+        setStatisticsEnabled(value >= 0.5f);
+    } else if (param == resetStatisticsId) {
+        if (currentOfxaaValue != NONE) {
+            _audioAnalyzer->resetStatistics(currentOfxaaValue);
+        }
     }
 }
 
@@ -95,29 +110,70 @@ bool MeterUnit::isEnabled() {
 }
 
 float MeterUnit::getValue() {
-    return outputMeter->getNormalizedValue();
+    if (!isEnabled()) return 0.0;
+    return _audioAnalyzer->getSnapshot().get(currentOfxaaValue).smoothedNormalized;
 }
 
 string MeterUnit::getTypeName() {
     return utils::valueTypeToString(currentOfxaaValue);
 }
 
+bool MeterUnit::getStatistics(ofxaa::DescriptorStatistics& result) {
+    if (!isEnabled()) return false;
+    return _audioAnalyzer->getStatistics(currentOfxaaValue, result);
+}
+
 void MeterUnit::setOfxaaValue(ofxAAValue value) {
+    if (currentOfxaaValue != NONE) {
+        _audioAnalyzer->unsubscribe(currentOfxaaValue);
+        if (statisticsEnabled) _audioAnalyzer->disableStatistics(currentOfxaaValue);
+    }
+    if (value != NONE) {
+        _audioAnalyzer->subscribe(value, *smoothing);
+        if (statisticsEnabled) _audioAnalyzer->enableStatistics(value);
+    }
     currentOfxaaValue = value;
+    applyNormalization();
     outputMeter->resetMaxValue();
 }
 
+void MeterUnit::applyNormalization() {
+    if (currentOfxaaValue == NONE) return;
+    auto mode = *normalization >= 0.5f ? ofxaa::ADAPTIVE_NORMALIZATION : ofxaa::FIXED_NORMALIZATION;
+    _audioAnalyzer->setNormalizationMode(currentOfxaaValue, mode, *adaptationTime);
+}
+
+void MeterUnit::setStatisticsEnabled(bool state) {
+    if (state == statisticsEnabled) return;
+    statisticsEnabled = state;
+    if (currentOfxaaValue == NONE) return;
+    if (state) {
+        _audioAnalyzer->enableStatistics(currentOfxaaValue);
+    } else {
+        _audioAnalyzer->disableStatistics(currentOfxaaValue);
+    }
+}
+
 void MeterUnit::prepareToPlay (double sampleRate, int samplesPerBlock) {
     outputMeter->setupSource (1); ///*** remove channels
-    oscilloscope->prepareToPlay (50, 0);
+    oscilloscope->prepareToPlay (sampleRate, samplesPerBlock);
 }
 
-void MeterUnit::process() {
+void MeterUnit::process(bool visualise) {
+    if (!visualise) {
+        isVisualising = false;
+        return;
+    }
+    if (!isVisualising) {
+        ///The history is stale after the editor was closed, start over instead of replaying it.
+        oscilloscope->resetHistory();
+        isVisualising = true;
+    }
+    
     if (isEnabled()) {
-        float value = _audioAnalyzer->getAverageValue(currentOfxaaValue, *smoothing, false);
-        float normalizedValue = _audioAnalyzer->getAverageValue(currentOfxaaValue, *smoothing, true);
-        outputMeter->setValues(value, normalizedValue);
-        oscilloscope->pushValue(normalizedValue);
+        auto& values = _audioAnalyzer->getSnapshot().get(currentOfxaaValue);
+        outputMeter->setValues(values.smoothed, values.smoothedNormalized);
+        oscilloscope->pushValue(values.smoothedNormalized);
     } else {
         outputMeter->setValues(0.0, 0.0);
         oscilloscope->pushValue(0.0);
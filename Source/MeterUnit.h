@@ -20,7 +20,8 @@ public:
     void setup(foleys::MagicProcessorState* magicState, juce::AudioProcessorValueTreeState* treeState, ofxAudioAnalyzer* audioAnalyzer);
     void parameterChanged (const juce::String& param, float value) override;
     void prepareToPlay (double sampleRate, int samplesPerBlock);
-    void process();
+    ///Pass visualise = false when no editor is open, then only the OSC value is kept up to date.
+    void process(bool visualise);
     
     
     unique_ptr<juce::AudioProcessorParameterGroup> getParameterGroup();
@@ -29,27 +30,42 @@ public:
     bool isEnabled();
     float getValue();
     string getTypeName();
+    ///The selected value is HPCP_CREST or HPCP_ENTROPY
+    bool isHpcpEnabled() { return currentOfxaaValue == HPCP_CREST || currentOfxaaValue == HPCP_ENTROPY; }
+    ///Statistics of the selected value, see ofxAudioAnalyzer::getStatistics()
+    bool isStatisticsEnabled() { return statisticsEnabled && isEnabled(); }
+    bool getStatistics(ofxaa::DescriptorStatistics& result);
     
     juce::String meterId;
     juce::String algorithmTypeId;
     juce::String smoothingId;
     juce::String resetMaxId;
     juce::String maxEstimatedId;
+    juce::String normalizationId;
+    juce::String adaptationTimeId;
+    juce::String statisticsId;
+    juce::String resetStatisticsId;
     juce::String outputMeterId;
     juce::String historyPlotId;
     
 private:
     void setOfxaaValue(ofxAAValue value);
+    void setStatisticsEnabled(bool state);
+    void applyNormalization();
     
     int _idx;
     ofxAudioAnalyzer* _audioAnalyzer;
 
     ofxAAValue currentOfxaaValue = NONE;
+    bool statisticsEnabled = false;
     foleys::MagicLevelSource* outputMeter  = nullptr;
-    foleys::MagicPlotSource*  oscilloscope = nullptr;
+    foleys::MagicOscilloscope* oscilloscope = nullptr;
+    bool isVisualising = false;
     
     atomic<bool>* resetMax  = nullptr;
     atomic<float>* smoothing  = nullptr;
     atomic<float>* maxEstimated  = nullptr;
+    atomic<float>* normalization  = nullptr;
+    atomic<float>* adaptationTime  = nullptr;
     
 };
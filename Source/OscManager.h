@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include "ofxAAProfiler.h"
+#include "ofxAAGovernor.h"
+#include "ofxAAStatistics.h"
+
 #define DEFAULT_OSC_HOST "127.0.0.1"
 #define DEFAULT_OSC_PORT 9001
 #define DEFAULT_OSC_MAIN_ID "trackId"
@@ -54,6 +58,60 @@ public:
         oscSender.send(addressPattern, value);
     }
     
+    /// Sends /<mainID>/<name> with one float per value
+    void sendValues(const std::vector<float>& values, juce::String name) {
+        sendValues (values.data(), (int) values.size(), name);
+    }
+    
+    void sendValues(const float* values, int numValues, juce::String name) {
+        if (!_isConnected) return;
+        juce::OSCMessage message ("/" + _mainID + "/" + name);
+        for (int i = 0; i < numValues; ++i)
+            message.addFloat32 (values[i]);
+        oscSender.send (message);
+    }
+    
+    /// Sends /<mainID>/governor level decimation disabledNodes load
+    void sendGovernorState(const ofxaa::Governor::State& state) {
+        if (!_isConnected) return;
+        juce::OSCMessage message ("/" + _mainID + "/governor");
+        message.addInt32 (state.level);
+        message.addInt32 (state.decimation);
+        message.addInt32 (state.disabledNodes);
+        message.addFloat32 (state.load);
+        oscSender.send (message);
+    }
+    
+    /// Sends /<mainID>/statistics/<name> count mean stdDev min max p5 p25 p50 p75 p95
+    void sendStatistics(const ofxaa::DescriptorStatistics& statistics, juce::String name) {
+        if (!_isConnected) return;
+        juce::OSCMessage message ("/" + _mainID + "/statistics/" + name);
+        message.addInt32 ((juce::int32) juce::jmin (statistics.getCount(), (uint64_t) std::numeric_limits<juce::int32>::max()));
+        message.addFloat32 (statistics.getMean());
+        message.addFloat32 (statistics.getStandardDeviation());
+        message.addFloat32 (statistics.getMin());
+        message.addFloat32 (statistics.getMax());
+        for (auto quantile : { 0.05, 0.25, 0.5, 0.75, 0.95 })
+            message.addFloat32 (statistics.getQuantile (quantile));
+        oscSender.send (message);
+    }
+    
+    /// Sends /<mainID>/profile/<node> meanNs p50Ns p99Ns maxNs count for every node that has run.
+    void sendProfile(const ofxaa::Profiler& profiler) {
+        if (!_isConnected) return;
+        for (int node = 0; node < ofxaa::Profiler::NodesNum; ++node) {
+            auto stats = profiler.getStats(node);
+            if (stats.count == 0) continue;
+            juce::OSCMessage message ("/" + _mainID + "/profile/" + ofxaa::Profiler::getNodeName(node));
+            message.addFloat32 ((float) stats.meanNs);
+            message.addFloat32 ((float) stats.p50Ns);
+            message.addFloat32 ((float) stats.p99Ns);
+            message.addFloat32 ((float) stats.maxNs);
+            message.addInt32 ((juce::int32) stats.count);
+            oscSender.send (message);
+        }
+    }
+    
 private:
     juce::OSCSender oscSender;
     juce::String _oscHost;
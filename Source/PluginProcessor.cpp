@@ -9,6 +9,10 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "StringUtils.h"
+#include "ofxAALogger.h"
+#include "BinaryData.h"
+
+#include <sstream>
 
 juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout(const vector<MeterUnit*>* meterUnits)
 {
@@ -24,7 +28,20 @@ juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout(const
                                                                      MIN_OSC_PORT,              // minimum value
                                                                      MAX_OSC_PORT,              // maximum value
                                                                      DEFAULT_OSC_PORT));
+    oscGenerator->addChild(std::make_unique<juce::AudioParameterBool>(IDs::oscProfile, IDs::oscProfileName, false));
     layout.add(std::move (oscGenerator));
+    
+    auto governorGenerator = std::make_unique<juce::AudioProcessorParameterGroup>("Governor", TRANS ("Governor"), "|");
+    governorGenerator->addChild(std::make_unique<juce::AudioParameterBool>(IDs::governor, IDs::governorName, true),
+                                std::make_unique<juce::AudioParameterFloat>(IDs::governorBudget, IDs::governorBudgetName,
+                                                                            juce::NormalisableRange<float>(0.1, 1.0, 0.01),
+                                                                            GOVERNOR_DEFAULT_BUDGET));
+    layout.add(std::move (governorGenerator));
+    
+    auto recordingGenerator = std::make_unique<juce::AudioProcessorParameterGroup>("Recording", TRANS ("Recording"), "|");
+    recordingGenerator->addChild(std::make_unique<juce::AudioParameterBool>(IDs::record, IDs::recordName, false),
+                                 std::make_unique<juce::AudioParameterBool>(IDs::replay, IDs::replayName, false));
+    layout.add(std::move (recordingGenerator));
     return layout;
 }
 
@@ -41,8 +58,10 @@ EssentiaPluginAudioProcessor::EssentiaPluginAudioProcessor()
                      #endif
                        ),
 #endif
-treeState (*this, nullptr, "PARAMETERS", createParameterLayout(&meterUnits))
+treeState (*this, nullptr, "PARAMETERS", createParameterLayout(&meterUnits)),
+instanceId (getNextInstanceId())
 {
+    ofxaa::setLogFunction ([](const char* message) { juce::Logger::outputDebugString (message); });
     
     audioAnalyzer.setup(44100, 1024, 1); ///*** this can be polished
     
@@ -50,9 +69,26 @@ treeState (*this, nullptr, "PARAMETERS", createParameterLayout(&meterUnits))
         unit->setup(&magicState, &treeState, &audioAnalyzer);
     }
     treeState.addParameterListener (IDs::oscPort, this);
+    treeState.addParameterListener (IDs::governor, this);
+    treeState.addParameterListener (IDs::governorBudget, this);
+    treeState.addParameterListener (IDs::oscProfile, this);
+    treeState.addParameterListener (IDs::record, this);
+    treeState.addParameterListener (IDs::replay, this);
+    magicState.addTrigger (IDs::chooseRecordingDirectory, [this] { chooseRecordingDirectory(); });
+    magicState.addTrigger (IDs::chooseReplayFile, [this] { chooseReplayFile(); });
+    governor.setEnabled (*treeState.getRawParameterValue (IDs::governor) > 0.5f);
+    governor.setBudget (*treeState.getRawParameterValue (IDs::governorBudget));
+    updateProfiler();
     magicState.setGuiValueTree (BinaryData::magic_xml, BinaryData::magic_xmlSize);
     
     magicState.addOscListener(this);
+    
+    startTimerHz (1);
+    
+    audioAnalyzer.getProfiler().setTraceRecorder (&traceRecorder);
+   #if ESSENTIALIGHT_TRACE
+    setTracing (true);
+   #endif
 }
 
 EssentiaPluginAudioProcessor::~EssentiaPluginAudioProcessor()
@@ -62,7 +98,12 @@ EssentiaPluginAudioProcessor::~EssentiaPluginAudioProcessor()
 // MARK: Preparte to play
 void EssentiaPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    if (isRecording() && (recorder.getSampleRate() != (int) sampleRate || recorder.getHopSize() != samplesPerBlock)) {
+        stopRecording();
+    }
+    
     audioAnalyzer.reset(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+    governor.prepare (audioAnalyzer, sampleRate);
    
     for (auto unit: meterUnits) {
         unit->prepareToPlay(sampleRate, samplesPerBlock);
@@ -70,11 +111,17 @@ void EssentiaPluginAudioProcessor::prepareToPlay (double sampleRate, int samples
     ///*** onsetsMeterUnit.prepareToPlay(sampleRate, samplesPerBlock);
     magicState.prepareOscData();
     magicState.prepareToPlay (sampleRate, samplesPerBlock);
+    
+    // (re)starts recording if its parameter is on
+    triggerAsyncUpdate();
 }
 
 // MARK: Process block
 void EssentiaPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    const auto blockStart = ofxaa::profiler::readTicks();
+    ofxaa::ScopedTraceSpan blockSpan (&traceRecorder, "processBlock");
+    
     //juce::ScopedNoDenormals noDenormals;
 //    auto totalNumInputChannels  = getTotalNumInputChannels();
 //    auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -82,21 +129,60 @@ void EssentiaPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
 //    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
 //        buffer.clear (i, 0, buffer.getNumSamples());
     
-    audioAnalyzer.analyze(buffer);
+    const auto hasTransport = magicState.updatePlayheadInformation (getPlayHead());
     
-    for (auto unit: meterUnits) {
-        unit->process();
+    auto analyzed = false;
+    if (isReplaying()) {
+        replayFrame (hasTransport, buffer.getNumSamples());
+    } else if (governor.shouldAnalyze()) {
+        audioAnalyzer.analyze(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+        analyzed = true;
+    } else {
+        audioAnalyzer.feed(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    }
+    
+    if (isRecording()) {
+        if (analyzed)
+            recordFrame (hasTransport);
+        recordedSamples += buffer.getNumSamples();
+    }
+    
+    const auto visualise = magicState.isEditorAttached();
+    {
+        ofxaa::ScopedTraceSpan span (&traceRecorder, "Meters");
+        for (auto unit: meterUnits) {
+            unit->process(visualise);
+        }
+    }
+    {
+        ofxaa::ScopedTraceSpan span (&traceRecorder, "OSC");
+        sendOscData();
     }
-    sendOscData();
+    
+    governor.blockFinished (audioAnalyzer, blockStart, ofxaa::profiler::readTicks(), buffer.getNumSamples());
 }
 //==============================================================================
 // MARK: OSC
 void EssentiaPluginAudioProcessor::parameterChanged (const juce::String& param, float value) {
     if (param == IDs::oscPort) {
         oscPortHasChanged(value);
+    } else if (param == IDs::governor) {
+        governor.setEnabled (value > 0.5f);
+        updateProfiler();
+    } else if (param == IDs::oscProfile) {
+        updateProfiler();
+    } else if (param == IDs::governorBudget) {
+        governor.setBudget (value);
+    } else if (param == IDs::record || param == IDs::replay) {
+        triggerAsyncUpdate();
     }
 }
 
+void EssentiaPluginAudioProcessor::updateProfiler() {
+    // only timed while someone reads the times
+    audioAnalyzer.getProfiler().setEnabled (governor.isEnabled() || *treeState.getRawParameterValue (IDs::oscProfile) > 0.5f);
+}
+
 void EssentiaPluginAudioProcessor::oscMainIDHasChanged (juce::String newOscMainID) {
     oscManager.setMaindId(newOscMainID);
 }
@@ -115,6 +201,206 @@ void EssentiaPluginAudioProcessor::sendOscData() {
             oscManager.sendValue(unit->getValue(), unit->getTypeName());
         }
     }
+    ///HPCP meters also send the chroma vector they're computed from (first channel)
+    if (! isHpcpSent())
+        return;
+    if (! isReplaying()) {
+        oscManager.sendValues(audioAnalyzer.getValues(HPCP, 0, 0.0, false), utils::binsValueTypeToString(HPCP));
+    } else if (replayHpcp.size > 0) {
+        oscManager.sendValues(replayHpcp.values.data(), replayHpcp.size, utils::binsValueTypeToString(HPCP));
+    }
+}
+
+bool EssentiaPluginAudioProcessor::isHpcpSent() {
+    for (auto unit: meterUnits) {
+        if (unit->isEnabled() && unit->isHpcpEnabled())
+            return true;
+    }
+    return false;
+}
+
+//==============================================================================
+// MARK: Recording and replay
+bool EssentiaPluginAudioProcessor::startRecording (const juce::File& file, juce::String& error) {
+    stopRecording();
+    
+    recordedValues.clear();
+    std::vector<ofxaa::FeatureColumn> columns;
+    for (int i = 0; i < NONE; ++i) {
+        auto value = static_cast<ofxAAValue> (i);
+        if (audioAnalyzer.isSubscribed (value)) {
+            recordedValues.push_back (value);
+            ofxaa::addDescriptorColumns (columns, value, utils::valueTypeToString (value));
+        }
+    }
+    if (recordedValues.empty()) {
+        error = "No descriptor is selected";
+        return false;
+    }
+    recordedHpcpBins = isHpcpSent() ? audioAnalyzer.getHpcpSettings().size : 0;
+    if (recordedHpcpBins > 0) {
+        ofxaa::FeatureColumn bins;
+        bins.name = utils::binsValueTypeToString (HPCP);
+        bins.isBins = true;
+        bins.id = HPCP;
+        bins.width = recordedHpcpBins;
+        columns.push_back (bins);
+    }
+    ofxaa::FeatureColumn transport;
+    transport.name = FEATURE_TRANSPORT_COLUMN;
+    columns.push_back (transport);
+    
+    recordedSamples = 0;
+    std::string recorderError;
+    if (! recorder.start (file.getFullPathName().toStdString(), (int) getSampleRate(), getBlockSize(), columns, recorderError)) {
+        error = recorderError;
+        return false;
+    }
+    return true;
+}
+
+bool EssentiaPluginAudioProcessor::stopRecording() {
+    return recorder.stop();
+}
+
+void EssentiaPluginAudioProcessor::handleAsyncUpdate() {
+    const auto shouldRecord = *treeState.getRawParameterValue (IDs::record) > 0.5f;
+    if (shouldRecord && ! isRecording()) {
+        // not prepared yet, prepareToPlay() calls again
+        if (getSampleRate() <= 0)
+            return;
+        juce::String error;
+        if (! startRecording (getNextRecordingFile(), error)) {
+            juce::Logger::outputDebugString (error);
+            if (auto* parameter = treeState.getParameter (IDs::record))
+                parameter->setValueNotifyingHost (0.0f);
+        }
+    } else if (! shouldRecord && isRecording()) {
+        stopRecording();
+    }
+    
+    const auto shouldReplay = *treeState.getRawParameterValue (IDs::replay) > 0.5f;
+    if (shouldReplay && ! isReplaying()) {
+        juce::String error;
+        if (! startReplay (juce::File (magicState.getPropertyAsValue (IDs::replayFile).toString()), error)) {
+            juce::Logger::outputDebugString (error);
+            if (auto* parameter = treeState.getParameter (IDs::replay))
+                parameter->setValueNotifyingHost (0.0f);
+        }
+    } else if (! shouldReplay && isReplaying()) {
+        stopReplay();
+    }
+}
+
+juce::File EssentiaPluginAudioProcessor::getNextRecordingFile() {
+    auto directory = juce::File (magicState.getPropertyAsValue (IDs::recordingDirectory).toString());
+    if (directory.getFullPathName().isEmpty() || ! directory.isDirectory())
+        directory = juce::File::getSpecialLocation (juce::File::tempDirectory);
+    return directory.getChildFile ("EssentiaLight-" + juce::String (instanceId) + "-"
+                                   + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S") + ".features")
+                    .getNonexistentSibling();
+}
+
+void EssentiaPluginAudioProcessor::chooseRecordingDirectory() {
+    fileChooser = std::make_unique<juce::FileChooser> (TRANS ("Recording directory"),
+                                                       juce::File (magicState.getPropertyAsValue (IDs::recordingDirectory).toString()));
+    fileChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+                              [this] (const juce::FileChooser& chooser) {
+                                  auto directory = chooser.getResult();
+                                  if (directory != juce::File())
+                                      magicState.getPropertyAsValue (IDs::recordingDirectory).setValue (directory.getFullPathName());
+                              });
+}
+
+void EssentiaPluginAudioProcessor::chooseReplayFile() {
+    fileChooser = std::make_unique<juce::FileChooser> (TRANS ("Feature file to replay"),
+                                                       juce::File (magicState.getPropertyAsValue (IDs::replayFile).toString()),
+                                                       "*.features");
+    fileChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                              [this] (const juce::FileChooser& chooser) {
+                                  auto file = chooser.getResult();
+                                  if (file == juce::File())
+                                      return;
+                                  magicState.getPropertyAsValue (IDs::replayFile).setValue (file.getFullPathName());
+                                  // a replay in progress switches to the new file
+                                  if (isReplaying()) {
+                                      stopReplay();
+                                      triggerAsyncUpdate();
+                                  }
+                              });
+}
+
+void EssentiaPluginAudioProcessor::recordFrame (bool hasTransport) {
+    if (hasTransport && ! magicState.isPlayheadPlaying())
+        return;
+    
+    auto* row = recorder.beginRow();
+    if (row == nullptr)
+        return;
+    
+    auto& snapshot = audioAnalyzer.getSnapshot();
+    for (auto value : recordedValues) {
+        *row++ = snapshot.get (value).smoothedNormalized;
+        *row++ = snapshot.get (value).smoothed;
+    }
+    if (recordedHpcpBins > 0) {
+        auto& bins = audioAnalyzer.getValues (HPCP, 0, 0.0, false);
+        for (int b = 0; b < recordedHpcpBins; ++b)
+            *row++ = b < (int) bins.size() ? bins[b] : 0.0f;
+    }
+    *row = hasTransport ? (float) magicState.getPlayheadTimeInSeconds()
+                        : (float) (recordedSamples.load() / getSampleRate());
+    recorder.commitRow();
+}
+
+void EssentiaPluginAudioProcessor::replayFrame (bool hasTransport, int numSamples) {
+    const auto seconds = hasTransport ? magicState.getPlayheadTimeInSeconds()
+                                      : replayedSamples.load() / getSampleRate();
+    replayedSamples += numSamples;
+    
+    if (replay.read (seconds, replaySnapshot, &replayHpcp))
+        audioAnalyzer.publishSnapshot (replaySnapshot);
+}
+
+bool EssentiaPluginAudioProcessor::startReplay (const juce::File& file, juce::String& error) {
+    replayedSamples = 0;
+    std::string replayError;
+    if (! replay.open (file.getFullPathName().toStdString(), replayError)) {
+        error = replayError;
+        return false;
+    }
+    return true;
+}
+
+//==============================================================================
+// MARK: Trace
+int EssentiaPluginAudioProcessor::getNextInstanceId() {
+    static std::atomic<int> nextId { 1 };
+    return nextId++;
+}
+
+bool EssentiaPluginAudioProcessor::writeTrace (const juce::File& file) const {
+    std::ostringstream stream;
+    auto name = juce::String (JucePlugin_Name) + " #" + juce::String (instanceId);
+    traceRecorder.writeChromeJson (stream, instanceId, name.toRawUTF8());
+    return file.replaceWithText (stream.str());
+}
+
+void EssentiaPluginAudioProcessor::timerCallback() {
+    // governor changes, then once a second while degraded
+    auto state = governor.getState();
+    if (state.level > 0 || state.level != lastSentGovernorLevel) {
+        oscManager.sendGovernorState (state);
+        lastSentGovernorLevel = state.level;
+    }
+    if (*treeState.getRawParameterValue (IDs::oscProfile) > 0.5f)
+        oscManager.sendProfile (audioAnalyzer.getProfiler());
+    
+    ofxaa::DescriptorStatistics statistics;
+    for (auto unit: meterUnits) {
+        if (unit->isStatisticsEnabled() && unit->getStatistics (statistics))
+            oscManager.sendStatistics (statistics, unit->getTypeName());
+    }
 }
 
 void EssentiaPluginAudioProcessor::postSetStateInformation() {
@@ -190,6 +476,11 @@ void EssentiaPluginAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+   #if ESSENTIALIGHT_TRACE
+    auto file = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                    .getChildFile ("EssentiaLight-trace-" + juce::String (instanceId) + ".json");
+    writeTrace (file);
+   #endif
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -12,6 +12,15 @@
 #include "ofxAudioAnalyzer.h"
 #include "MeterUnit.h"
 #include "OscManager.h"
+#include "ofxAATrace.h"
+#include "ofxAAGovernor.h"
+#include "ofxAAFeatureRecorder.h"
+#include "ofxAAFeatureReplay.h"
+
+#ifndef ESSENTIALIGHT_TRACE
+ /** Set to 1 to trace every block and write the trace to the temp directory in releaseResources() */
+ #define ESSENTIALIGHT_TRACE 0
+#endif
 
 using namespace std;
 
@@ -19,7 +28,9 @@ using namespace std;
 /**
 */
 class EssentiaPluginAudioProcessor  : public foleys::MagicProcessor,
-                                      private juce::AudioProcessorValueTreeState::Listener
+                                      private juce::AudioProcessorValueTreeState::Listener,
+                                      private juce::Timer,
+                                      private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -58,9 +69,58 @@ public:
     
     void postSetStateInformation() override;
     
+    /// Per-algorithm compute times, readable from the message thread.
+    const ofxaa::Profiler& getProfiler() const { return audioAnalyzer.getProfiler(); }
+    
+    /// Lowers the analysis rate and deactivates expensive descriptors when processBlock
+    /// takes more than its budget of the buffer period. Its state is sent over OSC.
+    /// Enabled and budgeted by the "Governor" parameters.
+    ofxaa::Governor& getGovernor() { return governor; }
+    
+    /// Records processBlock, analysis, meter and OSC spans of every block, see writeTrace().
+    void setTracing (bool shouldTrace) { traceRecorder.setEnabled (shouldTrace); }
+    bool isTracing() const { return traceRecorder.isEnabled(); }
+    
+    /// Writes the recorded spans as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+    /// Can be called while playing. Each instance shows up as its own process.
+    bool writeTrace (const juce::File& file) const;
+    
+    /// Records the descriptors subscribed when it starts to a feature file (see ofxAAFeatureFile.h):
+    /// one row per analyzed block while the host is playing, with the host transport time
+    /// (FEATURE_TRANSPORT_COLUMN). Without a host transport every block is recorded.
+    /// The audio thread only copies the values into a preallocated ring, the file is written
+    /// by a background thread. Stops by itself if the sample rate or block size change.
+    /// The "Record" parameter records to a new timestamped file of the recording directory.
+    bool startRecording (const juce::File& file, juce::String& error);
+    bool stopRecording();
+    bool isRecording() const { return recorder.isRecording(); }
+    const ofxaa::FeatureRecorder& getRecorder() const { return recorder; }
+    
+    /// Plays a feature file back instead of analyzing: every block publishes the recorded
+    /// values at the host transport position (or the time since the start without a transport),
+    /// so meters and OSC work as usual without computing anything.
+    /// The "Replay" parameter plays the file chosen in the GUI.
+    bool startReplay (const juce::File& file, juce::String& error);
+    void stopReplay() { replay.close(); }
+    bool isReplaying() const { return replay.isOpen(); }
+    
 private:
+    static int getNextInstanceId();
+    void timerCallback() override;
+    /// Starts or stops recording and replay to follow their parameters, on the message thread
+    void handleAsyncUpdate() override;
+    /// New file in the directory chosen in the GUI, the temp directory by default
+    juce::File getNextRecordingFile();
+    void chooseRecordingDirectory();
+    void chooseReplayFile();
     void connectOscSender(const juce::String& targetHostName, int targetPortNumber);
     void sendOscData();
+    /// The profiler runs while the governor or the profile export need it
+    void updateProfiler();
+    /// A meter shows an HPCP value, which also sends the HPCP vector
+    bool isHpcpSent();
+    void recordFrame (bool hasTransport);
+    void replayFrame (bool hasTransport, int numSamples);
     void showConnectionErrorMessage (const juce::String& messageText);
     
     ofxAudioAnalyzer audioAnalyzer;
@@ -73,6 +133,24 @@ private:
  
     juce::AudioProcessorValueTreeState treeState;
     OscManager oscManager;
+    
+    ofxaa::TraceRecorder traceRecorder;
+    const int instanceId;
+    
+    ofxaa::Governor governor;
+    int lastSentGovernorLevel = 0;
+    
+    ofxaa::FeatureRecorder recorder;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+    vector<ofxAAValue> recordedValues;
+    int recordedHpcpBins = 0;
+    std::atomic<juce::int64> recordedSamples { 0 };
+    
+    ofxaa::FeatureReplay replay;
+    ofxaa::FrameSnapshot replaySnapshot;
+    /// Copied by replay.read() so /HPCP never reads the replay's own storage
+    ofxaa::FeatureReplay::BinsFrame replayHpcp { HPCP };
+    std::atomic<juce::int64> replayedSamples { 0 };
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EssentiaPluginAudioProcessor)
 };
@@ -18,7 +18,7 @@
 
 #pragma once
 
-#include "ofxAudioAnalyzer.h"
+#include "ValueNames.h"
 
 //#define POWER_STRING "POWER"
 //#define PITCH_FREQ_STRING "PITCH-FREQ"
@@ -46,6 +46,10 @@ namespace IDs
     static juce::String smoothing  { "smoothing" };
     static juce::String resetMax  { "resetMax" };
     static juce::String maxEstimated  { "maxEstimated" };
+    static juce::String normalization  { "normalization" };
+    static juce::String adaptationTime  { "adaptationTime" };
+    static juce::String statistics  { "statistics" };
+    static juce::String resetStatistics  { "resetStatistics" };
 
     static juce::String outputMeter  { "outputMeter" };
     static juce::String historyPlot  { "historyPlot" };
@@ -57,99 +61,24 @@ namespace IDs
 
     static juce::String oscPort  { "oscPort" };
     static juce::String oscPortName  { "Osc Port" };
+    static juce::String oscProfile  { "oscProfile" };
+    static juce::String oscProfileName  { "Osc Profile" };
+    
+    static juce::String governor  { "governor" };
+    static juce::String governorName  { "Governor" };
+    static juce::String governorBudget  { "governorBudget" };
+    static juce::String governorBudgetName  { "Governor Budget" };
+    
+    static juce::String record  { "record" };
+    static juce::String recordName  { "Record" };
+    static juce::String recordingDirectory  { "recording:directory" };
+    static juce::String chooseRecordingDirectory  { "chooseRecordingDirectory" };
+    static juce::String replay  { "replay" };
+    static juce::String replayName  { "Replay" };
+    static juce::String replayFile  { "replay:file" };
+    static juce::String chooseReplayFile  { "chooseReplayFile" };
 
     static juce::String IDwithIdx(juce::String ID, int idx) {
         return ID +":" + juce::String(idx);
     }
 }
-
-namespace utils {
-    
-    static std::map<string, ofxAAValue> valuesMap = {
-        {"RMS", RMS},
-        {"POWER", POWER},
-        {"ZERO-CROSSING-RATE", ZERO_CROSSING_RATE},
-        {"LOUDNESS", LOUDNESS},
-//        {"LOUDNESS_VICKERS", LOUDNESS_VICKERS},
-        {"SILENCE-RATE-20dB", SILENCE_RATE_20dB},
-        {"SILENCE-RATE-30dB", SILENCE_RATE_30dB},
-        {"SILENCE-RATE-60dB", SILENCE_RATE_60dB},
-        
-        {"DYNAMIC_COMPLEXITY", DYNAMIC_COMPLEXITY},
-        {"DECREASE", DECREASE},
-        {"DISTRIBUTION_SHAPE_KURTOSIS", DISTRIBUTION_SHAPE_KURTOSIS},
-        {"DISTRIBUTION_SHAPE_SPREAD", DISTRIBUTION_SHAPE_SPREAD},
-        {"DISTRIBUTION_SHAPE_SKEWNESS", DISTRIBUTION_SHAPE_SKEWNESS},
-        {"LOG_ATTACK_TIME", LOG_ATTACK_TIME},
-        {"STRONG-DECAY", STRONG_DECAY},
-        {"FLATNESS-SFX", FLATNESS_SFX},
-        {"MAX-TO-TOTAL", MAX_TO_TOTAL},
-        {"TC-TO-TOTAL", TC_TO_TOTAL},
-        {"DERIVATIVE_SFX_AFTER_MAX", DERIVATIVE_SFX_AFTER_MAX},
-        {"DERIVATIVE_SFX_BEFORE_MAX", DERIVATIVE_SFX_BEFORE_MAX},
-        
-        {"MEL-KURTOSIS", MEL_BANDS_KURTOSIS},
-        {"MEL-SPREAD", MEL_BANDS_SPREAD},
-        {"MEL-SKEWNESS", MEL_BANDS_SKEWNESS},
-        {"MEL-FLATNESS", MEL_BANDS_FLATNESS_DB},
-        {"MEL-CREST", MEL_BANDS_CREST},
-        {"ERB-KURTOSIS", ERB_BANDS_KURTOSIS},
-        {"ERB-SPREAD", ERB_BANDS_SPREAD},
-        {"ERB-SKEWNESS", ERB_BANDS_SKEWNESS},
-        {"ERB-FLATNESS", ERB_BANDS_FLATNESS_DB},
-        {"ERB-CREST", ERB_BANDS_CREST},
-        {"BARK-KURTOSIS", BARK_BANDS_KURTOSIS},
-        {"BARK-SPREAD", BARK_BANDS_SPREAD},
-        {"BARK-SKEWNESS", BARK_BANDS_SKEWNESS},
-        {"BARK-FLATNESS", BARK_BANDS_FLATNESS_DB},
-        {"BARK-CREST", BARK_BANDS_CREST},
-        {"ENERGY-BAND-LOW", ENERGY_BAND_LOW},
-        {"ENERGY-BAND-MID-LOW", ENERGY_BAND_MID_LOW},
-        {"ENERGY-BAND-MID-HI", ENERGY_BAND_MID_HI},
-        {"ENERGY-BAND-HI", ENERGY_BAND_HI},
-        
-        {"SPEC-KURTOSIS", SPECTRAL_KURTOSIS},
-        {"SPEC-SPREAD", SPECTRAL_SPREAD},
-        {"SPEC-SKEWNESS", SPECTRAL_SKEWNESS},
-        {"SPEC-DECREASE", SPECTRAL_DECREASE},
-        {"SPEC-ROLLOFF", SPECTRAL_ROLLOFF},
-        {"SPEC-ENERGY", SPECTRAL_ENERGY},
-        {"SPEC-ENTROPY", SPECTRAL_ENTROPY},
-        {"SPEC-CENTROID", SPECTRAL_CENTROID},
-        {"SPEC-COMPLEXITY", SPECTRAL_COMPLEXITY},
-        {"SPEC-FLUX", SPECTRAL_FLUX},
-        {"DISSONANCE", DISSONANCE},
-        {"HFC", HFC},
-        {"PITCH-SALIENCE", PITCH_SALIENCE},
-        {"INHARMONICITY", INHARMONICITY},
-        {"ODD-EVEN", ODD_TO_EVEN},
-        {"STRONG-PEAK", STRONG_PEAK},
-        {"HPCP-CREST", HPCP_CREST},
-        {"HPCP-ENTROPY", HPCP_ENTROPY},
-        {"PITCH-FREQUENCY", PITCH_YIN_FREQUENCY},
-        {"PITCH-CONFIDENCE", PITCH_YIN_CONFIDENCE},
-        {"ONSETS", ONSETS},
-        {"NONE", NONE}
-    };
-    
-    static std::map<string, ofxAABinsValue> binValuesMap = {
-        {"SPECTRUM", SPECTRUM},
-        {"MEL-BANDS", MFCC_MEL_BANDS},
-        {"GFCC-ERB-BANDS", GFCC_ERB_BANDS},
-        {"BARK-BANDS", BARK_BANDS},
-        {"TRISTIMULUS", TRISTIMULUS},
-        {"HPCP", HPCP},
-        {"PITCH_MELODIA_FREQUENCIES", PITCH_MELODIA_FREQUENCIES},
-        {"PITCH_MELODIA_CONFIDENCES", PITCH_MELODIA_CONFIDENCES},
-        {"PREDOMINANT_PITCH_MELODIA_FREQUENCIES", PREDOMINANT_PITCH_MELODIA_FREQUENCIES},
-        {"PREDOMINANT_PITCH_MELODIA_CONFIDENCES", PREDOMINANT_PITCH_MELODIA_CONFIDENCES},
-        {"NONE_BINS", NONE_BINS}
-    };
-    
-    string valueTypeToString(ofxAAValue value);
-    string binsValueTypeToString(ofxAABinsValue value);
-    
-    ofxAAValue stringToValueType(string stringType);
-    ofxAABinsValue stringToBinsValueType(string stringType);
-    
-}
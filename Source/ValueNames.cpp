@@ -1,12 +1,12 @@
 //
-//  ofxAAUtils.cpp
+//  ValueNames.cpp
 //  Sonoscopio
 //
 //  Created by Leo on 11/09/2018.
 //
 
 //#include "ofxAAUtils.h"
-#include "StringUtils.h"
+#include "ValueNames.h"
 
 namespace utils {
     string valueTypeToString(ofxAAValue value) {
@@ -45,4 +45,12 @@ namespace utils {
         return NONE_BINS;
     }
     
+    ofxAAValue choiceIndexToValueType(int choiceIndex) {
+        int index = choiceIndex - 1;
+        if (index < 0 || index >= availableValuesList.size()) {
+            return NONE;
+        }
+        return availableValuesList[index];
+    }
+    
 };
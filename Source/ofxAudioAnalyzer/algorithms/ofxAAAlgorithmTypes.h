@@ -110,6 +110,8 @@ namespace ofxaa {
         MultiPitchMelodia,
         PredominantPitchMelodia
     };
+    
+    const int AlgorithmTypesNum = PredominantPitchMelodia + 1;
 
 }
 
@@ -37,6 +37,22 @@ ofxAABaseAlgorithm::ofxAABaseAlgorithm(ofxaa::AlgorithmType algorithmType, int s
     algorithm = ofxaa::createAlgorithmWithType(_algorithmType, samplerate, framesize);
     
     isActive = true;
+    _profiler = NULL;
+    
+    hasLogarithmicValues = false;
+    hasDbValues = false;
+    isNormalizedByDefault = false;
+    minEstimatedValue = 0.0;
+    maxEstimatedValue = 1.0;
+}
+//-------------------------------------------
+ofxAABaseAlgorithm::ofxAABaseAlgorithm(ofxaa::AlgorithmType algorithmType){
+    _algorithmType = algorithmType;
+    
+    algorithm = NULL;
+    
+    isActive = true;
+    _profiler = NULL;
     
     hasLogarithmicValues = false;
     hasDbValues = false;
@@ -47,7 +63,10 @@ ofxAABaseAlgorithm::ofxAABaseAlgorithm(ofxaa::AlgorithmType algorithmType, int s
 
 //-------------------------------------------
 void ofxAABaseAlgorithm::compute(){
-    if(isActive){
+    if(isActive && algorithm != NULL){
+#if OFXAA_ENABLE_PROFILER
+        ofxaa::ScopedProfile profile(_profiler, _algorithmType);
+#endif
         algorithm->compute();
     }
 }
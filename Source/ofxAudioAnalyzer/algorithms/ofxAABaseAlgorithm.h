@@ -26,6 +26,7 @@
 
 ///
 #include "ofxAAAlgorithmTypes.h"
+#include "ofxAAProfiler.h"
 
 #include "algorithmfactory.h"
 #include "essentiamath.h"
@@ -43,6 +44,10 @@ public:
     
     ofxAABaseAlgorithm(ofxaa::AlgorithmType algorithmType, int samplerate, int framesize);
     
+    ///Wrapper of an output of an algorithm computed by another wrapper: algorithm is NULL
+    ///and compute() does nothing, the owner of the algorithm sets the outputs.
+    explicit ofxAABaseAlgorithm(ofxaa::AlgorithmType algorithmType);
+    
     virtual ~ofxAABaseAlgorithm() = default;
     
     virtual void compute();
@@ -51,6 +56,12 @@ public:
     
     virtual void deleteAlgorithm();
     
+    ///Sets the outputs to what silence gives, without computing. The base class keeps them.
+    virtual void setSilent(){}
+    
+    ///Times every compute() in the profiler node of the algorithm type. nullptr disables it.
+    virtual void setProfiler(ofxaa::Profiler* profiler){ _profiler = profiler; }
+    
     Algorithm* algorithm;
     
     bool isActive;
@@ -65,5 +76,6 @@ public:
 protected:
     float smooth(float newValue, float previousValue, float amount);
     ofxaa::AlgorithmType _algorithmType;
+    ofxaa::Profiler* _profiler;
     
 };
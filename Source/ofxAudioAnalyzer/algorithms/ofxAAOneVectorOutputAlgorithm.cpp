@@ -31,6 +31,11 @@ ofxAAOneVectorOutputAlgorithm::ofxAAOneVectorOutputAlgorithm(ofxaa::AlgorithmTyp
     hasLogarithmicValues = false;
 }
 //-------------------------------------------
+ofxAAOneVectorOutputAlgorithm::ofxAAOneVectorOutputAlgorithm(ofxaa::AlgorithmType algorithmType, int outputSize) : ofxAABaseAlgorithm(algorithmType){
+    
+    assignOutputValuesSize(outputSize, 0.0);
+}
+//-------------------------------------------
 void ofxAAOneVectorOutputAlgorithm::assignOutputValuesSize(int size, int val){
     outputValues.assign(size, val);
     checkInternalValuesSizes();
@@ -56,6 +61,10 @@ void ofxAAOneVectorOutputAlgorithm::compute(){
     }
 }
 //-------------------------------------------
+void ofxAAOneVectorOutputAlgorithm::setSilent(){
+    std::fill(outputValues.begin(), outputValues.end(), hasDbValues ? dbSilenceCutoff : 0.0);
+}
+//-------------------------------------------
 float ofxAAOneVectorOutputAlgorithm::getValueAtIndex(int index, float smooth, bool normalized){
     return getValues(smooth, normalized)[index];
 }
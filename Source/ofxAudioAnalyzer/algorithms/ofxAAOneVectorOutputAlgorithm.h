@@ -36,7 +36,12 @@ public:
     
     ofxAAOneVectorOutputAlgorithm(ofxaa::AlgorithmType algorithmType, int samplerate, int framesize, int outputSize);
     
+    ///Output of an algorithm owned by another wrapper, see ofxAABaseAlgorithm.
+    ofxAAOneVectorOutputAlgorithm(ofxaa::AlgorithmType algorithmType, int outputSize);
+    
     void compute() override;
+    ///0.0 values, dbSilenceCutoff for dB values
+    void setSilent() override;
     //void updateLogRealValues();
     
     //This is only used for chordDetection at the moment...
@@ -24,7 +24,7 @@
 
 #include "ofxAAConfigurations.h"
 #include "ofxAAOnsetsAlgorithm.h"
-#include <JuceHeader.h>
+#include <chrono>
 
 #define ONSETS_DETECTIONS_BUFFER_SIZE 32 //64
 
@@ -98,6 +98,9 @@ void ofxAAOnsetsAlgorithm::connectAlgorithms(){
 //-------------------------------------------
 void ofxAAOnsetsAlgorithm::compute(){
     if (isActive){
+#if OFXAA_ENABLE_PROFILER
+        ofxaa::ScopedProfile profile(_profiler, _algorithmType);
+#endif
         fft->compute();
         cartesianToPolar->compute();
         onsetHfc->compute();
@@ -107,6 +110,15 @@ void ofxAAOnsetsAlgorithm::compute(){
     }
 }
 //-------------------------------------------
+void ofxAAOnsetsAlgorithm::setProfiler(ofxaa::Profiler* profiler){
+    ofxAABaseAlgorithm::setProfiler(profiler);
+    fft->setProfiler(profiler);
+    cartesianToPolar->setProfiler(profiler);
+    onsetHfc->setProfiler(profiler);
+    onsetComplex->setProfiler(profiler);
+    onsetFlux->setProfiler(profiler);
+}
+//-------------------------------------------
 void ofxAAOnsetsAlgorithm::evaluate(){
     //is current buffer an Onset?
     bool isCurrentBufferOnset = onsetBufferEvaluation(onsetHfc->outputValue, onsetComplex->outputValue, onsetFlux->outputValue);
@@ -203,7 +215,7 @@ bool ofxAAOnsetsAlgorithm::onsetTimeThresholdEvaluation(){
     
     bool onsetTimeEvaluation = false;
     
-    long long currentTime = juce::Time::getCurrentTime().toMilliseconds();
+    long long currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
     
     //elapsed time since last onset:
     long long elapsed = currentTime - lastOnsetTime;
@@ -43,6 +43,8 @@ public:
     
     void compute() override;
     
+    ///Also profiles the fft, cartesian to polar and onset detection algorithms.
+    void setProfiler(ofxaa::Profiler* profiler) override;
     
     void reset();
     
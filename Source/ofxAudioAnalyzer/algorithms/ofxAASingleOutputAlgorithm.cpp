@@ -29,6 +29,14 @@ ofxAASingleOutputAlgorithm::ofxAASingleOutputAlgorithm(ofxaa::AlgorithmType algo
     outputValue = 0.0;
     _smoothedValue = 0.0;
     _smoothedNormValue = 0.0;
+    _adaptiveNormalization = false;
+}
+//-------------------------------------------
+ofxAASingleOutputAlgorithm::ofxAASingleOutputAlgorithm(ofxaa::AlgorithmType algorithmType) : ofxAABaseAlgorithm(algorithmType) {
+    outputValue = 0.0;
+    _smoothedValue = 0.0;
+    _smoothedNormValue = 0.0;
+    _adaptiveNormalization = false;
 }
 
 //-------------------------------------------
@@ -39,6 +47,10 @@ void ofxAASingleOutputAlgorithm::compute(){
     }
 }
 //-------------------------------------------
+void ofxAASingleOutputAlgorithm::setSilent(){
+    outputValue = hasDbValues ? dbSilenceCutoff : 0.0;
+}
+//-------------------------------------------
 float ofxAASingleOutputAlgorithm::getValue(float smooth, bool normalized){
     if (normalized){
         float normValue = normalizedValue();
@@ -51,7 +63,7 @@ float ofxAASingleOutputAlgorithm::getValue(float smooth, bool normalized){
     }
 }
 //-------------------------------------------
-float ofxAASingleOutputAlgorithm::linearValue(){
+float ofxAASingleOutputAlgorithm::linearValue() const {
     if (hasLogarithmicValues){
         /*
         lin2db-> 0.001 = -30
@@ -66,8 +78,10 @@ float ofxAASingleOutputAlgorithm::linearValue(){
     }
 }
 //-------------------------------------------
-float ofxAASingleOutputAlgorithm::normalizedValue(){
-    if (isNormalizedByDefault || hasLogarithmicValues) {
+float ofxAASingleOutputAlgorithm::normalizedValue() const {
+    if (_adaptiveNormalization) {
+        return _adaptiveRange.map(adaptiveRangeValue());
+    } else if (isNormalizedByDefault || hasLogarithmicValues) {
         return linearValue();
     } else if (hasDbValues){
         float dbMax = 0.0;
@@ -77,6 +91,19 @@ float ofxAASingleOutputAlgorithm::normalizedValue(){
     }
 }
 //-------------------------------------------
+void ofxAASingleOutputAlgorithm::setAdaptiveNormalization(bool state, int adaptationFrames){
+    _adaptiveNormalization = state;
+    _adaptiveRange.setAdaptationFrames(adaptationFrames);
+}
+//-------------------------------------------
+void ofxAASingleOutputAlgorithm::updateAdaptiveRange(){
+    _adaptiveRange.add(adaptiveRangeValue());
+}
+//-------------------------------------------
+float ofxAASingleOutputAlgorithm::adaptiveRangeValue() const {
+    return hasLogarithmicValues ? lin2db(outputValue) : outputValue;
+}
+//-------------------------------------------
 void ofxAASingleOutputAlgorithm::smoothValue(float& valueToSmooth, float& smoothedValue, float smthAmnt){
     if (smthAmnt == 0){
         smoothedValue = valueToSmooth;
@@ -25,26 +25,44 @@
 #pragma once
 
 #include "ofxAABaseAlgorithm.h"
+#include "ofxAAStatistics.h"
 
 class ofxAASingleOutputAlgorithm : public ofxAABaseAlgorithm {
 public:
     
     ofxAASingleOutputAlgorithm(ofxaa::AlgorithmType algorithmType, int samplerate, int framesize);
+    ///Output of an algorithm owned by another wrapper, see ofxAABaseAlgorithm.
+    explicit ofxAASingleOutputAlgorithm(ofxaa::AlgorithmType algorithmType);
     
     void compute() override;
+    ///0.0, dbSilenceCutoff for dB values
+    void setSilent() override;
     
     Real outputValue;
     
     float getValue(float smooth, bool normalized);
     
+    ///Unsmoothed values. Unlike getValue() these don't touch the smoothing state.
+    float normalizedValue() const;
+    float linearValue() const;
+    
+    ///Normalizes by the recent range of the values (dB for logarithmic values) instead of the
+    ///min/max estimated values, see ofxaa::AdaptiveRange. Changing it starts the range over.
+    void setAdaptiveNormalization(bool state, int adaptationFrames);
+    bool getIsAdaptiveNormalization() const { return _adaptiveNormalization; }
+    ///Adds the value of the computed frame to the adaptive range.
+    void updateAdaptiveRange();
+    
 private:
     
-    float normalizedValue();
-    float linearValue();
+    float adaptiveRangeValue() const;
     
     void smoothValue(float& valueToSmooth, float& smoothedValue, float smthAmnt);
     
     float _smoothedValue;
     float _smoothedNormValue;
     
+    bool _adaptiveNormalization;
+    ofxaa::AdaptiveRange _adaptiveRange;
+    
 };
@@ -48,6 +48,11 @@ void ofxAATwoVectorsOutputAlgorithm::checkInternalValuesSizes() {
     }
 }
 
+void ofxAATwoVectorsOutputAlgorithm::setSilent() {
+    ofxAAOneVectorOutputAlgorithm::setSilent();
+    std::fill(outputValues_2.begin(), outputValues_2.end(), hasDbValues ? dbSilenceCutoff : 0.0);
+}
+
 vector<float>& ofxAATwoVectorsOutputAlgorithm::getValues2(float smooth, bool normalized){
     checkInternalValuesSizes();
     
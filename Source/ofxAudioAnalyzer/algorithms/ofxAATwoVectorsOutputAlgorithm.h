@@ -35,6 +35,7 @@ public:
     
     void assignSecondOutpuValuesSize(int size, int val);
     void checkInternalValuesSizes() override;
+    void setSilent() override;
     
     vector<float>& getValues2(float smooth, bool normalized);
     
@@ -163,4 +163,68 @@ namespace ofxaa {
         }
     }
     
+    //----------------------------------------------
+    const char* algorithmTypeToString(ofxaa::AlgorithmType algorithmType){
+        switch (algorithmType) {
+            case Onsets: return "Onsets";
+            case Windowing: return "Windowing";
+            case DCRemoval: return "DCRemoval";
+            case Rms: return "RMS";
+            case InstantPower: return "InstantPower";
+            case StrongDecay: return "StrongDecay";
+            case ZeroCrossingRate: return "ZeroCrossingRate";
+            case LoudnessVickers: return "LoudnessVickers";
+            case Loudness: return "Loudness";
+            case SilenceRate: return "SilenceRate";
+            case CentralMoments: return "CentralMoments";
+            case Centroid: return "Centroid";
+            case Decrease: return "Decrease";
+            case DistributionShape: return "DistributionShape";
+            case DerivativeSFX: return "DerivativeSFX";
+            case Envelope: return "Envelope";
+            case FlatnessSFX: return "FlatnessSFX";
+            case LogAttackTime: return "LogAttackTime";
+            case MaxToTotal: return "MaxToTotal";
+            case TCToTotal: return "TCToTotal";
+            case Spectrum: return "Spectrum";
+            case SpectrumCQ: return "SpectrumCQ";
+            case SpectralComplexity: return "SpectralComplexity";
+            case StrongPeak: return "StrongPeak";
+            case MelBands: return "MelBands";
+            case Mfcc: return "MFCC";
+            case Hfc: return "HFC";
+            case RollOff: return "RollOff";
+            case Energy: return "Energy";
+            case Dissonance: return "Dissonance";
+            case PitchSalience: return "PitchSalience";
+            case UnaryOperator: return "UnaryOperator";
+            case BarkBands: return "BarkBands";
+            case EnergyBand: return "EnergyBand";
+            case FlatnessDB: return "FlatnessDB";
+            case Flux: return "Flux";
+            case Gfcc: return "GFCC";
+            case Crest: return "Crest";
+            case Entropy: return "Entropy";
+            case DynamicComplexity: return "DynamicComplexity";
+            case SpectralPeaks: return "SpectralPeaks";
+            case HarmonicPeaks: return "HarmonicPeaks";
+            case OddToEven: return "OddToEvenHarmonicEnergyRatio";
+            case Inharmonicity: return "Inharmonicity";
+            case Tristimulus: return "Tristimulus";
+            case NSGConstantQ: return "NSGConstantQ";
+            case PitchYinFFT: return "PitchYinFFT";
+            case PitchMelodia: return "PitchMelodia";
+            case MultiPitchKlapuri: return "MultiPitchKlapuri";
+            case MultiPitchMelodia: return "MultiPitchMelodia";
+            case PredominantPitchMelodia: return "PredominantPitchMelodia";
+            case EqualLoudness: return "EqualLoudness";
+            case Hpcp: return "HPCP";
+            case ChordsDetection: return "ChordsDetection";
+            case CartesianToPolar: return "CartesianToPolar";
+            case Fft: return "FFT";
+            case OnsetDetection: return "OnsetDetection";
+            default: return "Unknown";
+        }
+    }
+    
 }
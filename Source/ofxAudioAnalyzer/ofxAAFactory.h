@@ -39,4 +39,6 @@ using namespace standard;
 
 namespace ofxaa {
     Algorithm* createAlgorithmWithType(ofxaa::AlgorithmType algorithmType, int samplerate, int framesize);
+    ///Name of the Essentia algorithm created for the type.
+    const char* algorithmTypeToString(ofxaa::AlgorithmType algorithmType);
 }
@@ -0,0 +1,394 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAFeatureFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define FEATURE_FILE_MMAP 1
+#endif
+
+namespace ofxaa {
+    
+    static const char fileMagic[8] = { 'O', 'F', 'X', 'A', 'A', 'F', 'T', '\0' };
+    static const char groupMagic[4] = { 'R', 'G', 'R', 'P' };
+    
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t sampleRate;
+        uint32_t hopSize;
+        uint32_t numColumns;
+        uint32_t reserved[2];
+    };
+    
+    struct ColumnHeader {
+        uint16_t isBins;
+        uint16_t id;
+        uint16_t variant;
+        uint16_t reserved;
+        uint32_t width;
+        uint32_t reserved2;
+        char name[FEATURE_NAME_LENGTH];
+    };
+    
+    struct GroupHeader {
+        char magic[4];
+        uint32_t numRows;
+        uint64_t firstRow;
+    };
+    
+    static_assert(sizeof(FileHeader) == 32 && sizeof(ColumnHeader) == 64 && sizeof(GroupHeader) == 16,
+                  "feature file headers are written as is");
+    
+    ///Moves to offset and drops everything after it
+    static bool truncateAt(std::FILE* file, uint64_t offset){
+#if defined(_WIN32)
+        return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+        return fseeko(file, (off_t)offset, SEEK_SET) == 0 && ftruncate(fileno(file), (off_t)offset) == 0;
+#endif
+    }
+    
+    void addDescriptorColumns(std::vector<FeatureColumn>& columns, ofxAAValue value, const std::string& name){
+        FeatureColumn column;
+        column.id = value;
+        column.name = name;
+        column.variant = SMOOTHED_NORMALIZED_VARIANT;
+        columns.push_back(column);
+        column.name = name + ".raw";
+        column.variant = SMOOTHED_VARIANT;
+        columns.push_back(column);
+    }
+    
+    //MARK: - WRITER
+    
+    bool FeatureFileWriter::open(const std::string& path, int sampleRate, int hopSize,
+                                 const std::vector<FeatureColumn>& columns, bool append, std::string& error){
+        close();
+        failed = false;
+        _columns = columns;
+        rowWidth = 0;
+        for (auto& column : columns){
+            if (column.width <= 0){
+                error = "invalid width of column " + column.name;
+                return false;
+            }
+            rowWidth += column.width;
+        }
+        if (rowWidth == 0){
+            error = "no columns";
+            return false;
+        }
+        buffer.assign(size_t(rowWidth) * FEATURE_ROW_GROUP_SIZE, 0.0);
+        group.assign(buffer.size(), 0.0);
+        bufferedRows = 0;
+        firstBufferedRow = 0;
+        
+        std::FILE* existing = append ? std::fopen(path.c_str(), "r+b") : NULL;
+        if (existing != NULL){
+            FeatureFileReader reader;
+            if (!reader.open(path, error)){
+                std::fclose(existing);
+                return false;
+            }
+            if (reader.getSampleRate() != sampleRate || reader.getHopSize() != hopSize || reader.getColumns() != columns){
+                std::fclose(existing);
+                error = path + " has a different sample rate, hop size or columns";
+                return false;
+            }
+            firstBufferedRow = reader.getNumRows();
+            
+            ///drops a row group cut short by a crash (on Windows it is overwritten instead,
+            ///and the reader stops at whatever is left of it)
+            file = existing;
+            if (!truncateAt(file, reader.getValidSize())){
+                error = "can't append to " + path;
+                close();
+                return false;
+            }
+            return true;
+        }
+        
+        file = std::fopen(path.c_str(), "wb");
+        if (file == NULL){
+            error = "can't write " + path;
+            return false;
+        }
+        FileHeader header = {};
+        std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+        header.version = FEATURE_FILE_VERSION;
+        header.sampleRate = sampleRate;
+        header.hopSize = hopSize;
+        header.numColumns = (uint32_t)columns.size();
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        for (auto& column : columns){
+            ColumnHeader columnHeader = {};
+            columnHeader.isBins = column.isBins;
+            columnHeader.id = (uint16_t)column.id;
+            columnHeader.variant = (uint16_t)column.variant;
+            columnHeader.width = column.width;
+            std::strncpy(columnHeader.name, column.name.c_str(), FEATURE_NAME_LENGTH - 1);
+            ok = ok && std::fwrite(&columnHeader, sizeof(columnHeader), 1, file) == 1;
+        }
+        if (!ok){
+            error = "can't write " + path;
+            close();
+            return false;
+        }
+        return true;
+    }
+    //----------------------------------------------
+    void FeatureFileWriter::addRow(const float* values){
+        if (file == NULL) return;
+        std::copy_n(values, rowWidth, buffer.data() + size_t(bufferedRows) * rowWidth);
+        bufferedRows++;
+        if (bufferedRows == FEATURE_ROW_GROUP_SIZE){
+            flush();
+        }
+    }
+    //----------------------------------------------
+    bool FeatureFileWriter::flush(){
+        if (file == NULL || bufferedRows == 0) return !failed;
+        
+        ///rows to columns
+        float* out = group.data();
+        int offset = 0;
+        for (auto& column : _columns){
+            for (int row=0; row<bufferedRows; row++){
+                const float* in = buffer.data() + size_t(row) * rowWidth + offset;
+                out = std::copy_n(in, column.width, out);
+            }
+            offset += column.width;
+        }
+        
+        GroupHeader header;
+        std::memcpy(header.magic, groupMagic, sizeof(groupMagic));
+        header.numRows = bufferedRows;
+        header.firstRow = firstBufferedRow;
+        size_t count = size_t(bufferedRows) * rowWidth;
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1
+            || std::fwrite(group.data(), sizeof(float), count, file) != count
+            || std::fflush(file) != 0){
+            failed = true;
+        }
+        firstBufferedRow += bufferedRows;
+        bufferedRows = 0;
+        return !failed;
+    }
+    //----------------------------------------------
+    bool FeatureFileWriter::close(){
+        if (file == NULL) return !failed;
+        flush();
+        if (std::fclose(file) != 0){
+            failed = true;
+        }
+        file = NULL;
+        return !failed;
+    }
+    
+    //MARK: - READER
+    
+    bool FeatureFileReader::open(const std::string& path, std::string& error){
+        close();
+#if FEATURE_FILE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0){
+            error = "can't open " + path;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(FileHeader)){
+            ::close(fd);
+            error = path + " isn't a feature file";
+            return false;
+        }
+        void* address = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED){
+            error = "can't map " + path;
+            return false;
+        }
+        data = static_cast<const uint8_t*>(address);
+        size = (size_t)info.st_size;
+        isMapped = true;
+#else
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream){
+            error = "can't open " + path;
+            return false;
+        }
+        fileContents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        data = fileContents.data();
+        size = fileContents.size();
+#endif
+        if (!parse(error)){
+            error = path + ": " + error;
+            close();
+            return false;
+        }
+        return true;
+    }
+    //----------------------------------------------
+    void FeatureFileReader::close(){
+#if FEATURE_FILE_MMAP
+        if (isMapped && data != NULL){
+            munmap(const_cast<uint8_t*>(data), size);
+        }
+#endif
+        data = NULL;
+        size = 0;
+        isMapped = false;
+        fileContents.clear();
+        _columns.clear();
+        columnOffsets.clear();
+        groups.clear();
+        numRows = 0;
+        validSize = 0;
+    }
+    //----------------------------------------------
+    bool FeatureFileReader::parse(std::string& error){
+        FileHeader header;
+        if (size < sizeof(header)){
+            error = "not a feature file";
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0){
+            error = "not a feature file";
+            return false;
+        }
+        if (header.version != FEATURE_FILE_VERSION){
+            error = "unsupported feature file version " + std::to_string(header.version);
+            return false;
+        }
+        _samplerate = header.sampleRate;
+        _hopsize = header.hopSize;
+        
+        size_t offset = sizeof(header);
+        if (size < offset + size_t(header.numColumns) * sizeof(ColumnHeader)){
+            error = "truncated header";
+            return false;
+        }
+        rowWidth = 0;
+        for (uint32_t c=0; c<header.numColumns; c++){
+            ColumnHeader columnHeader;
+            std::memcpy(&columnHeader, data + offset, sizeof(columnHeader));
+            offset += sizeof(columnHeader);
+            
+            FeatureColumn column;
+            column.name.assign(columnHeader.name, strnlen(columnHeader.name, FEATURE_NAME_LENGTH));
+            column.isBins = columnHeader.isBins != 0;
+            column.id = columnHeader.id;
+            column.variant = (FeatureVariant)columnHeader.variant;
+            column.width = (int)columnHeader.width;
+            _columns.push_back(column);
+            columnOffsets.push_back(rowWidth);
+            rowWidth += column.width;
+        }
+        if (rowWidth <= 0){
+            error = "no columns";
+            return false;
+        }
+        
+        ///complete row groups, in order; anything after the first broken one is ignored
+        validSize = offset;
+        while (offset + sizeof(GroupHeader) <= size){
+            GroupHeader groupHeader;
+            std::memcpy(&groupHeader, data + offset, sizeof(groupHeader));
+            uint64_t bytes = uint64_t(groupHeader.numRows) * rowWidth * sizeof(float);
+            if (std::memcmp(groupHeader.magic, groupMagic, sizeof(groupMagic)) != 0
+                || groupHeader.firstRow != (uint64_t)numRows
+                || offset + sizeof(GroupHeader) + bytes > size){
+                break;
+            }
+            offset += sizeof(GroupHeader);
+            groups.push_back({ numRows, groupHeader.numRows, reinterpret_cast<const float*>(data + offset) });
+            numRows += groupHeader.numRows;
+            offset += bytes;
+            validSize = offset;
+        }
+        return true;
+    }
+    //----------------------------------------------
+    int FeatureFileReader::findColumn(const std::string& name) const {
+        for (size_t c=0; c<_columns.size(); c++){
+            if (_columns[c].name == name) return (int)c;
+        }
+        return -1;
+    }
+    //----------------------------------------------
+    int FeatureFileReader::findColumn(ofxAAValue value, FeatureVariant variant) const {
+        for (size_t c=0; c<_columns.size(); c++){
+            if (!_columns[c].isBins && _columns[c].id == value && _columns[c].variant == variant) return (int)c;
+        }
+        return -1;
+    }
+    //----------------------------------------------
+    int FeatureFileReader::findColumn(ofxAABinsValue value) const {
+        for (size_t c=0; c<_columns.size(); c++){
+            if (_columns[c].isBins && _columns[c].id == value) return (int)c;
+        }
+        return -1;
+    }
+    //----------------------------------------------
+    const FeatureFileReader::RowGroup* FeatureFileReader::groupForRow(int64_t row) const {
+        if (row < 0 || row >= numRows) return NULL;
+        auto next = std::upper_bound(groups.begin(), groups.end(), row,
+                                     [](int64_t r, const RowGroup& g){ return r < g.firstRow; });
+        return &*(next - 1);
+    }
+    //----------------------------------------------
+    const float* FeatureFileReader::getColumnData(int column, int64_t row, int64_t& rows) const {
+        rows = 0;
+        auto rowGroup = groupForRow(row);
+        if (rowGroup == NULL || column < 0 || column >= (int)_columns.size()) return NULL;
+        
+        int width = _columns[column].width;
+        const float* columnStart = rowGroup->data + rowGroup->numRows * columnOffsets[column];
+        rows = rowGroup->firstRow + rowGroup->numRows - row;
+        return columnStart + (row - rowGroup->firstRow) * width;
+    }
+    //----------------------------------------------
+    float FeatureFileReader::getValue(int column, int64_t row, int bin) const {
+        int64_t rows;
+        const float* values = getColumnData(column, row, rows);
+        if (values == NULL || bin < 0 || bin >= _columns[column].width) return 0.0;
+        return values[bin];
+    }
+    //----------------------------------------------
+    int64_t FeatureFileReader::rowAtTime(double seconds) const {
+        if (numRows == 0 || _hopsize <= 0) return 0;
+        auto row = (int64_t)std::floor(seconds * _samplerate / _hopsize);
+        return std::max<int64_t>(0, std::min(row, numRows - 1));
+    }
+}
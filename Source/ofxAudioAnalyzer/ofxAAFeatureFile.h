@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAAValues.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define FEATURE_FILE_VERSION 1
+#define FEATURE_NAME_LENGTH 48
+///Rows buffered by FeatureFileWriter before it writes a row group
+#define FEATURE_ROW_GROUP_SIZE 4096
+///Column with the host transport time of each row, in seconds (recordings of the plug-in)
+#define FEATURE_TRANSPORT_COLUMN "transport.time"
+
+namespace ofxaa {
+    
+    ///Which of the DescriptorValues of a value a column holds.
+    enum FeatureVariant {
+        RAW_VARIANT,
+        NORMALIZED_VARIANT,
+        SMOOTHED_VARIANT,
+        SMOOTHED_NORMALIZED_VARIANT
+    };
+    
+    ///One column of a feature file: a descriptor value, or the bins of a vector output.
+    struct FeatureColumn {
+        std::string name;
+        ///id is an ofxAABinsValue instead of an ofxAAValue
+        bool isBins = false;
+        int id = NONE;
+        FeatureVariant variant = RAW_VARIANT;
+        ///values per row, the number of bins of vector outputs
+        int width = 1;
+        
+        bool operator==(const FeatureColumn& other) const {
+            return name == other.name && isBins == other.isBins && id == other.id
+                && variant == other.variant && width == other.width;
+        }
+        bool operator!=(const FeatureColumn& other) const { return !(*this == other); }
+    };
+    
+    ///Appends the two columns written for a descriptor: name, its smoothed normalized value
+    ///(what is sent over OSC), and name.raw, its smoothed value.
+    void addDescriptorColumns(std::vector<FeatureColumn>& columns, ofxAAValue value, const std::string& name);
+    
+    //----------------------------------------------
+    // Feature file layout (little endian, every field 4-byte aligned):
+    //
+    //   header        "OFXAAFT" magic, version, sample rate, hop size, columns number
+    //   column * N    kind, id, variant, width, name
+    //   row group *   "RGRP", rows number, first row, then for every column its
+    //                 rows * width floats, contiguous
+    //
+    // Row groups make the file appendable while keeping each column contiguous inside a group,
+    // so it can be memory-mapped and read column by column. A group cut short by a crash is
+    // ignored by the reader and replaced by the next append.
+    //----------------------------------------------
+    
+    ///Writes a feature file, FEATURE_ROW_GROUP_SIZE rows at a time.
+    ///Not thread-safe, and addRow() can write to disk: not for the audio thread.
+    class FeatureFileWriter {
+    public:
+        ~FeatureFileWriter(){ close(); }
+        
+        ///Creates the file, or with append appends to an existing file with the same sample rate,
+        ///hop size and columns (and creates it if it doesn't exist).
+        bool open(const std::string& path, int sampleRate, int hopSize,
+                  const std::vector<FeatureColumn>& columns, bool append, std::string& error);
+        bool isOpen() const { return file != NULL; }
+        
+        ///One row: the values of every column one after the other, getRowWidth() floats.
+        void addRow(const float* values);
+        ///Writes the buffered rows. False if writing failed (every write since too).
+        bool flush();
+        bool close();
+        
+        int getRowWidth() const { return rowWidth; }
+        ///Rows in the file, including the buffered ones.
+        int64_t getNumRows() const { return firstBufferedRow + bufferedRows; }
+        
+    private:
+        std::FILE* file = NULL;
+        std::vector<FeatureColumn> _columns;
+        int rowWidth = 0;
+        ///row major, converted to columns by flush()
+        std::vector<float> buffer;
+        std::vector<float> group;
+        int bufferedRows = 0;
+        int64_t firstBufferedRow = 0;
+        bool failed = false;
+    };
+    
+    ///Random access to a feature file through a read-only memory mapping
+    ///(the file is read into memory where mmap isn't available).
+    class FeatureFileReader {
+    public:
+        ~FeatureFileReader(){ close(); }
+        
+        bool open(const std::string& path, std::string& error);
+        void close();
+        bool isOpen() const { return data != NULL; }
+        
+        int getSampleRate() const { return _samplerate; }
+        int getHopSize() const { return _hopsize; }
+        int64_t getNumRows() const { return numRows; }
+        const std::vector<FeatureColumn>& getColumns() const { return _columns; }
+        ///-1 if there isn't such column
+        int findColumn(const std::string& name) const;
+        int findColumn(ofxAAValue value, FeatureVariant variant) const;
+        int findColumn(ofxAABinsValue value) const;
+        
+        ///Value of a column at a row, bin for vector outputs. 0.0 out of range.
+        float getValue(int column, int64_t row, int bin=0) const;
+        ///Contiguous values of a column from row to the end of its row group, rows * width floats.
+        ///rows is set to the number of rows available, 0 if row is out of range.
+        const float* getColumnData(int column, int64_t row, int64_t& rows) const;
+        ///Row at the time in seconds, clamped to the file.
+        int64_t rowAtTime(double seconds) const;
+        ///Bytes up to the end of the last complete row group.
+        uint64_t getValidSize() const { return validSize; }
+        
+    private:
+        struct RowGroup {
+            int64_t firstRow;
+            int64_t numRows;
+            const float* data;
+        };
+        const RowGroup* groupForRow(int64_t row) const;
+        bool parse(std::string& error);
+        
+        const uint8_t* data = NULL;
+        size_t size = 0;
+        bool isMapped = false;
+        std::vector<uint8_t> fileContents;
+        
+        int _samplerate = 0;
+        int _hopsize = 0;
+        std::vector<FeatureColumn> _columns;
+        ///offset of each column in a row, in floats
+        std::vector<int> columnOffsets;
+        int rowWidth = 0;
+        std::vector<RowGroup> groups;
+        int64_t numRows = 0;
+        uint64_t validSize = 0;
+    };
+}
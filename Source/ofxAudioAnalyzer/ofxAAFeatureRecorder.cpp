@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAFeatureRecorder.h"
+
+#include <chrono>
+
+namespace ofxaa {
+    
+    bool FeatureRecorder::start(const std::string& path, int sampleRate, int hopSize,
+                                const std::vector<FeatureColumn>& columns, std::string& error){
+        stop();
+        if (!writer.open(path, sampleRate, hopSize, columns, false, error)){
+            return false;
+        }
+        _samplerate = sampleRate;
+        _hopsize = hopSize;
+        rowWidth = writer.getRowWidth();
+        ring.assign(size_t(rowWidth) * FEATURE_RECORDER_CAPACITY, 0.0);
+        writeIndex = 0;
+        readIndex = 0;
+        droppedRows = 0;
+        
+        stopRequested = false;
+        writerThread = std::thread(&FeatureRecorder::runWriter, this);
+        active = true;
+        return true;
+    }
+    //----------------------------------------------
+    bool FeatureRecorder::stop(){
+        if (!writer.isOpen()) return true;
+        
+        active = false;
+        while (audioThreadBusy){
+            std::this_thread::yield();
+        }
+        
+        stopRequested = true;
+        writerThread.join();
+        drain();
+        return writer.close();
+    }
+    //----------------------------------------------
+    float* FeatureRecorder::beginRow(){
+        audioThreadBusy = true;
+        if (!active){
+            audioThreadBusy = false;
+            return nullptr;
+        }
+        auto write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) >= FEATURE_RECORDER_CAPACITY){
+            droppedRows.fetch_add(1, std::memory_order_relaxed);
+            audioThreadBusy = false;
+            return nullptr;
+        }
+        return ring.data() + (write % FEATURE_RECORDER_CAPACITY) * rowWidth;
+    }
+    //----------------------------------------------
+    void FeatureRecorder::commitRow(){
+        writeIndex.store(writeIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        audioThreadBusy = false;
+    }
+    //----------------------------------------------
+    void FeatureRecorder::runWriter(){
+        while (!stopRequested){
+            drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(FEATURE_RECORDER_PERIOD_MS));
+        }
+    }
+    //----------------------------------------------
+    void FeatureRecorder::drain(){
+        auto read = readIndex.load(std::memory_order_relaxed);
+        auto write = writeIndex.load(std::memory_order_acquire);
+        for (; read < write; read++){
+            writer.addRow(ring.data() + (read % FEATURE_RECORDER_CAPACITY) * rowWidth);
+            readIndex.store(read + 1, std::memory_order_release);
+        }
+    }
+}
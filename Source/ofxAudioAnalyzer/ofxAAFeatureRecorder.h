@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAAFeatureFile.h"
+
+#include <atomic>
+#include <thread>
+
+///Rows the ring holds before the audio thread starts dropping them
+#define FEATURE_RECORDER_CAPACITY 32768
+///How often the writer thread empties the ring, in milliseconds
+#define FEATURE_RECORDER_PERIOD_MS 100
+
+namespace ofxaa {
+    ///Records rows of descriptor values to a feature file without any I/O or allocation on the
+    ///thread that captures them: rows are written in place into a preallocated single producer /
+    ///single consumer ring, that a background thread drains into a FeatureFileWriter
+    ///(which writes FEATURE_ROW_GROUP_SIZE rows at a time).
+    ///
+    ///start() and stop() are for one control thread, beginRow() and commitRow() for the audio thread.
+    class FeatureRecorder {
+    public:
+        ~FeatureRecorder(){ stop(); }
+        
+        bool start(const std::string& path, int sampleRate, int hopSize,
+                   const std::vector<FeatureColumn>& columns, std::string& error);
+        ///Waits for the audio thread to finish its row, writes what is left and closes the file.
+        ///False if any write failed.
+        bool stop();
+        bool isRecording() const { return active.load(); }
+        
+        ///Row to fill with getRowWidth() values, nullptr if not recording or if the ring is full.
+        ///Every non-null beginRow() needs its commitRow().
+        float* beginRow();
+        void commitRow();
+        
+        int getSampleRate() const { return _samplerate; }
+        int getHopSize() const { return _hopsize; }
+        int getRowWidth() const { return rowWidth; }
+        ///Rows lost because the writer thread fell behind, since start().
+        uint64_t getDroppedRows() const { return droppedRows.load(); }
+        uint64_t getRecordedRows() const { return readIndex.load(); }
+        
+    private:
+        void runWriter();
+        void drain();
+        
+        FeatureFileWriter writer;
+        std::vector<float> ring;
+        int rowWidth = 0;
+        int _samplerate = 0;
+        int _hopsize = 0;
+        
+        std::atomic<uint64_t> writeIndex { 0 };
+        std::atomic<uint64_t> readIndex { 0 };
+        std::atomic<uint64_t> droppedRows { 0 };
+        
+        ///Dekker style handshake between beginRow() and stop(): the ring is only released
+        ///once the audio thread has seen active == false.
+        std::atomic<bool> active { false };
+        std::atomic<bool> audioThreadBusy { false };
+        
+        std::thread writerThread;
+        std::atomic<bool> stopRequested { false };
+    };
+}
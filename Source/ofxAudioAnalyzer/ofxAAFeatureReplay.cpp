@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAFeatureReplay.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace ofxaa {
+    
+    bool FeatureReplay::open(const std::string& path, std::string& error){
+        close();
+        if (!reader.open(path, error)) return false;
+        
+        descriptors.clear();
+        for (int i=0; i<NONE; i++){
+            auto value = static_cast<ofxAAValue>(i);
+            Descriptor descriptor { value, reader.findColumn(value, SMOOTHED_NORMALIZED_VARIANT), reader.findColumn(value, SMOOTHED_VARIANT) };
+            if (descriptor.normalizedColumn >= 0 || descriptor.rawColumn >= 0){
+                descriptors.push_back(descriptor);
+            }
+        }
+        if (descriptors.empty() || reader.getNumRows() == 0){
+            error = path + " has no descriptor values";
+            reader.close();
+            return false;
+        }
+        transportColumn = reader.findColumn(FEATURE_TRANSPORT_COLUMN);
+        
+        for (int i=0; i<NONE_BINS; i++){
+            binsColumns[i] = reader.findColumn(static_cast<ofxAABinsValue>(i));
+        }
+        
+        active = true;
+        return true;
+    }
+    //----------------------------------------------
+    void FeatureReplay::close(){
+        active = false;
+        while (audioThreadBusy){
+            std::this_thread::yield();
+        }
+        reader.close();
+    }
+    //----------------------------------------------
+    int64_t FeatureReplay::rowAtTime(double seconds) const {
+        if (transportColumn < 0){
+            return reader.rowAtTime(seconds);
+        }
+        ///last row recorded at or before the time
+        int64_t first = 0;
+        int64_t last = reader.getNumRows() - 1;
+        while (first < last){
+            int64_t middle = (first + last + 1) / 2;
+            if (reader.getValue(transportColumn, middle) <= seconds){
+                first = middle;
+            } else {
+                last = middle - 1;
+            }
+        }
+        return first;
+    }
+    //----------------------------------------------
+    bool FeatureReplay::read(double seconds, FrameSnapshot& snapshot, BinsFrame* bins){
+        audioThreadBusy = true;
+        if (!active){
+            audioThreadBusy = false;
+            return false;
+        }
+        
+        auto row = rowAtTime(seconds);
+        snapshot.subscribed.fill(false);
+        for (auto& descriptor : descriptors){
+            auto& values = snapshot.values[descriptor.value];
+            values.smoothedNormalized = reader.getValue(descriptor.normalizedColumn, row);
+            values.smoothed = reader.getValue(descriptor.rawColumn, row);
+            values.normalized = values.smoothedNormalized;
+            values.raw = values.smoothed;
+            snapshot.subscribed[descriptor.value] = true;
+        }
+        if (bins != NULL){
+            int column = bins->value < NONE_BINS ? binsColumns[bins->value] : -1;
+            bins->size = column < 0 ? 0 : std::min(reader.getColumns()[column].width, (int)bins->values.size());
+            for (int b=0; b<bins->size; b++){
+                bins->values[b] = reader.getValue(column, row, b);
+            }
+        }
+        
+        audioThreadBusy = false;
+        return true;
+    }
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAAFeatureFile.h"
+#include "ofxAASnapshot.h"
+
+#include <array>
+#include <atomic>
+
+///Default capacity of a FeatureReplay::BinsFrame, more than the HPCP sizes the plug-in records
+#define FEATURE_REPLAY_BINS_CAPACITY 128
+
+namespace ofxaa {
+    ///Plays back a feature file (recorded by the plug-in or written by the batch analyzer) as
+    ///FrameSnapshots, without running any analysis.
+    ///
+    ///Rows are found by time: with the FEATURE_TRANSPORT_COLUMN of plug-in recordings (which are
+    ///expected to be one pass over the arrangement, the column must not go backwards), otherwise
+    ///from the hop size and sample rate of the file.
+    ///
+    ///open() and close() are for one control thread, read() for the audio thread.
+    class FeatureReplay {
+    public:
+        ///Bins of a vector output at the row of read(), in storage owned by the caller so they
+        ///stay valid whatever open() and close() do.
+        struct BinsFrame {
+            BinsFrame(ofxAABinsValue value, int capacity = FEATURE_REPLAY_BINS_CAPACITY) : value(value), values(capacity, 0.0) {}
+            ofxAABinsValue value;
+            ///allocated once, read() never resizes it
+            std::vector<float> values;
+            ///bins read, 0 if the file hasn't the vector output
+            int size = 0;
+        };
+        
+        ~FeatureReplay(){ close(); }
+        
+        bool open(const std::string& path, std::string& error);
+        ///Waits for a read() in progress to finish.
+        void close();
+        bool isOpen() const { return active.load(); }
+        
+        ///Values of the row at the time, for the descriptors in the file (other values aren't
+        ///subscribed in the snapshot). False if nothing is open. No allocation, no locks.
+        ///\param bins: also copies the bins of its vector output, up to its capacity.
+        bool read(double seconds, FrameSnapshot& snapshot, BinsFrame* bins = NULL);
+        
+    private:
+        int64_t rowAtTime(double seconds) const;
+        
+        struct Descriptor {
+            ofxAAValue value;
+            int normalizedColumn;
+            int rawColumn;
+        };
+        
+        FeatureFileReader reader;
+        std::vector<Descriptor> descriptors;
+        ///bins column of every ofxAABinsValue, -1 if it isn't in the file
+        std::array<int, NONE_BINS> binsColumns;
+        int transportColumn = -1;
+        
+        ///same handshake as FeatureRecorder
+        std::atomic<bool> active { false };
+        std::atomic<bool> audioThreadBusy { false };
+    };
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAGovernor.h"
+#include "ofxAudioAnalyzer.h"
+
+#include <cmath>
+
+namespace ofxaa {
+
+    void Governor::prepare(ofxAudioAnalyzer& analyzer, double sampleRate){
+        restoreAll(analyzer);
+        _samplerate = sampleRate > 0 ? sampleRate : 44100;
+        ///the first call calibrates for a few ms, keep it off the audio thread
+        ticksPerNanosecond = profiler::ticksPerNanosecond();
+        smoothedLoad = 0.0;
+        blocksSinceChange = 0;
+        blockCounter = 0;
+        blockAnalyzed = false;
+        load.store(0.0);
+    }
+    //----------------------------------------------
+    bool Governor::shouldAnalyze(){
+        int n = decimation.load(std::memory_order_relaxed);
+        blockCounter = (blockCounter + 1) % n;
+        blockAnalyzed = blockCounter == 0;
+        return blockAnalyzed;
+    }
+    //----------------------------------------------
+    void Governor::blockFinished(ofxAudioAnalyzer& analyzer, uint64_t startTicks, uint64_t endTicks, int numSamples){
+        if (!isEnabled()){
+            if (decimation.load(std::memory_order_relaxed) > 1 || disabledCount.load(std::memory_order_relaxed) > 0){
+                restoreAll(analyzer);
+            }
+            return;
+        }
+        ///skipped and replayed blocks say nothing about the cost of the analysis
+        bool analyzed = blockAnalyzed;
+        blockAnalyzed = false;
+        if (!analyzed || numSamples <= 0) return;
+
+        double blockNs = 1.0e9 * numSamples / _samplerate;
+        double elapsedNs = (endTicks > startTicks ? endTicks - startTicks : 0) / ticksPerNanosecond;
+        smoothedLoad = smoothedLoad * GOVERNOR_LOAD_SMOOTHING + (1.0 - GOVERNOR_LOAD_SMOOTHING) * elapsedNs / blockNs;
+        load.store((float)smoothedLoad, std::memory_order_relaxed);
+
+        if (++blocksSinceChange < GOVERNOR_HOLD_BLOCKS) return;
+
+        float budget = getBudget();
+        if (smoothedLoad > budget){
+            degrade(analyzer);
+        } else if (loadAfterRestore(analyzer, blockNs) < budget * GOVERNOR_RESTORE_MARGIN){
+            restore(analyzer);
+        }
+    }
+    //----------------------------------------------
+    double Governor::loadAfterRestore(ofxAudioAnalyzer& analyzer, double blockNs){
+        if (decimation.load(std::memory_order_relaxed) > 1){
+            ///analyzing more often doesn't change the cost of an analyzed block
+            return smoothedLoad;
+        }
+        int count = disabledCount.load(std::memory_order_relaxed);
+        if (count > 0){
+            ///last known cost of the node, in every channel
+            auto& units = analyzer.getChannelAnalyzersPtrs();
+            double cost = analyzer.getNodeCostNs(disabled[count - 1]) * units.size();
+            return smoothedLoad + cost / blockNs;
+        }
+        ///nothing to restore
+        return HUGE_VAL;
+    }
+    //----------------------------------------------
+    void Governor::degrade(ofxAudioAnalyzer& analyzer){
+        ///Most expensive subscribed node that's still computed
+        if (analyzer.getChannelAnalyzersPtrs().empty()) return;
+        ofxAAValue candidate = NONE;
+        double candidateCost = 0.0;
+        for (int i=0; i<NONE; i++){
+            auto valueType = static_cast<ofxAAValue>(i);
+            if (!analyzer.isNodeSubscribed(valueType) || !analyzer.getIsNodeActive(valueType)) continue;
+            double cost = analyzer.getNodeCostNs(valueType);
+            if (candidate == NONE || cost > candidateCost){
+                candidate = valueType;
+                candidateCost = cost;
+            }
+        }
+        if (candidate == NONE){
+            int n = decimation.load(std::memory_order_relaxed);
+            if (n < GOVERNOR_MAX_DECIMATION){
+                decimation.store(n * 2, std::memory_order_relaxed);
+                blocksSinceChange = 0;
+            }
+            return;
+        }
+
+        analyzer.setNodeActive(candidate, false);
+        int count = disabledCount.load(std::memory_order_relaxed);
+        disabled[count] = candidate;
+        disabledCount.store(count + 1, std::memory_order_relaxed);
+        blocksSinceChange = 0;
+    }
+    //----------------------------------------------
+    void Governor::restore(ofxAudioAnalyzer& analyzer){
+        int n = decimation.load(std::memory_order_relaxed);
+        if (n > 1){
+            decimation.store(n / 2, std::memory_order_relaxed);
+            blocksSinceChange = 0;
+            return;
+        }
+        int count = disabledCount.load(std::memory_order_relaxed);
+        if (count > 0){
+            analyzer.setNodeActive(disabled[count - 1], true);
+            disabledCount.store(count - 1, std::memory_order_relaxed);
+            blocksSinceChange = 0;
+        }
+    }
+    //----------------------------------------------
+    void Governor::restoreAll(ofxAudioAnalyzer& analyzer){
+        int count = disabledCount.load(std::memory_order_relaxed);
+        for (int i=0; i<count; i++){
+            analyzer.setNodeActive(disabled[i], true);
+        }
+        disabledCount.store(0, std::memory_order_relaxed);
+        decimation.store(1, std::memory_order_relaxed);
+        blocksSinceChange = 0;
+    }
+    //----------------------------------------------
+    Governor::State Governor::getState() const {
+        State state;
+        state.decimation = decimation.load(std::memory_order_relaxed);
+        state.disabledNodes = disabledCount.load(std::memory_order_relaxed);
+        state.load = load.load(std::memory_order_relaxed);
+        int steps = 0;
+        for (int n = state.decimation; n > 1; n /= 2) steps++;
+        state.level = steps + state.disabledNodes;
+        return state;
+    }
+}
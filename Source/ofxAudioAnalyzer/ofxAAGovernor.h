@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAAValues.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#define GOVERNOR_DEFAULT_BUDGET 0.6
+#define GOVERNOR_RESTORE_MARGIN 0.8
+#define GOVERNOR_LOAD_SMOOTHING 0.9
+#define GOVERNOR_HOLD_BLOCKS 32
+#define GOVERNOR_MAX_DECIMATION 4
+
+class ofxAudioAnalyzer;
+
+namespace ofxaa {
+
+    ///Keeps the analysis within a share of the audio buffer period.
+    ///
+    ///The load is the time of a whole analyzed block (as measured by the caller) over the block
+    ///duration, smoothed over the analyzed blocks: skipping blocks doesn't make the ones that are
+    ///analyzed any faster. While it's above the budget the governor degrades one step every
+    ///GOVERNOR_HOLD_BLOCKS analyzed blocks: it deactivates the most expensive subscribed node (an
+    ///algorithm, or the pitch or HPCP engine as a whole, see ofxAudioAnalyzer::getNodeCostNs()),
+    ///according to the analyzer profiler, and once there's nothing left to deactivate it halves
+    ///the analysis rate (up to 1 in GOVERNOR_MAX_DECIMATION blocks), which only lowers the average.
+    ///A step is undone (in reverse order) when the load it would add back still leaves the analyzed
+    ///blocks under budget * GOVERNOR_RESTORE_MARGIN.
+    ///
+    ///shouldAnalyze() and blockFinished() are for the audio thread, getState() and the setters
+    ///can be called from any thread.
+    class Governor {
+    public:
+        struct State {
+            ///Number of degradation steps currently applied, 0 = full analysis
+            int level = 0;
+            ///1 block analyzed every `decimation` blocks
+            int decimation = 1;
+            int disabledNodes = 0;
+            ///Smoothed analyzed block time / block duration
+            float load = 0.0;
+        };
+
+        ///Call before processing starts, after the analyzer has been set up (not realtime safe).
+        ///Undoes all degradation. The nodes are ranked with the analyzer profiler: keep it
+        ///enabled while the governor is, their cost reads 0 otherwise.
+        void prepare(ofxAudioAnalyzer& analyzer, double sampleRate);
+
+        ///Share of the buffer period the block may take, e.g. 0.6 = 60%.
+        void setBudget(float budget){ _budget.store(budget, std::memory_order_relaxed); }
+        float getBudget() const { return _budget.load(std::memory_order_relaxed); }
+
+        ///Disabling the governor restores full analysis on the next block.
+        void setEnabled(bool enabled){ _enabled.store(enabled, std::memory_order_relaxed); }
+        bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+        ///False for the blocks skipped by the decimation.
+        bool shouldAnalyze();
+
+        ///\param startTicks, endTicks: profiler::readTicks() around the whole block.
+        ///Only blocks that shouldAnalyze() let through count towards the load.
+        void blockFinished(ofxAudioAnalyzer& analyzer, uint64_t startTicks, uint64_t endTicks, int numSamples);
+
+        State getState() const;
+
+    private:
+        void degrade(ofxAudioAnalyzer& analyzer);
+        void restore(ofxAudioAnalyzer& analyzer);
+        void restoreAll(ofxAudioAnalyzer& analyzer);
+        ///Estimated load after undoing the last step
+        double loadAfterRestore(ofxAudioAnalyzer& analyzer, double blockNs);
+
+        std::atomic<float> _budget { GOVERNOR_DEFAULT_BUDGET };
+        std::atomic<bool> _enabled { true };
+
+        double _samplerate = 44100;
+        double ticksPerNanosecond = 1.0;
+        double smoothedLoad = 0.0;
+        int blocksSinceChange = 0;
+        int blockCounter = 0;
+        bool blockAnalyzed = false;
+
+        ///Values deactivated by the governor, in order
+        std::array<ofxAAValue, NONE> disabled;
+
+        std::atomic<int> decimation { 1 };
+        std::atomic<int> disabledCount { 0 };
+        std::atomic<float> load { 0.0 };
+    };
+}
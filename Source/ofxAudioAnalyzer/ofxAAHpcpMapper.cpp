@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAHpcpMapper.h"
+
+#include <algorithm>
+#include <cmath>
+
+///Divides by the maximum (unitMax), leaves all-zero values as they are
+static void normalizeMax(std::vector<float>& values){
+    float maxValue = *std::max_element(values.begin(), values.end());
+    if (maxValue <= 0.0) return;
+    for (auto& value : values){
+        value /= maxValue;
+    }
+}
+
+namespace ofxaa {
+    
+    void HpcpMapper::prepare(const HpcpSettings& settings){
+        _settings = settings;
+        _settings.size = std::max(12, settings.size / 12 * 12);
+        _settings.harmonics = std::max(0, settings.harmonics);
+        resolution = _settings.size / 12;
+        
+        ///Essentia's harmonic table: harmonic n adds to the pitch class of the peak frequency / n
+        ///with a strength of 1 / max(1, octaves above the fundamental / 2)
+        harmonicOffsets.clear();
+        harmonicEnergies.clear();
+        for (int n=1; n<=_settings.harmonics + 1; n++){
+            float octaves = std::log2((float)n);
+            float strength = 1.0 / std::max(1.0f, octaves * 0.5f);
+            harmonicOffsets.push_back(-octaves * _settings.size);
+            harmonicEnergies.push_back(strength * strength);
+        }
+        
+        ///A peak at fraction u above a bin reaches the bins from ceil(u - resolution/2) to
+        ///floor(u + resolution/2), at most resolution + 1 of them
+        int weights = resolution + 1;
+        windowFirstBins.assign(HPCP_WINDOW_TABLE_STEPS + 1, 0);
+        windowWeights.assign((HPCP_WINDOW_TABLE_STEPS + 1) * weights, 0.0);
+        for (int step=0; step<=HPCP_WINDOW_TABLE_STEPS; step++){
+            float u = (float)step / HPCP_WINDOW_TABLE_STEPS;
+            int first = (int)std::ceil(u - resolution * 0.5f);
+            windowFirstBins[step] = first;
+            for (int i=0; i<weights; i++){
+                float semitones = std::fabs(u - (first + i)) / resolution;
+                if (semitones < 0.5){
+                    float w = std::cos(M_PI * semitones);
+                    windowWeights[step * weights + i] = w * w;
+                }
+            }
+        }
+        
+        lowBand.assign(_settings.size, 0.0);
+        highBand.assign(_settings.size, 0.0);
+    }
+    //----------------------------------------------
+    void HpcpMapper::compute(const std::vector<float>& frequencies, const std::vector<float>& magnitudes, std::vector<float>& hpcp){
+        int size = _settings.size;
+        int weights = resolution + 1;
+        std::fill(lowBand.begin(), lowBand.end(), 0.0);
+        std::fill(highBand.begin(), highBand.end(), 0.0);
+        
+        auto peaks = std::min(frequencies.size(), magnitudes.size());
+        for (size_t p=0; p<peaks; p++){
+            float frequency = frequencies[p];
+            if (frequency < HPCP_MIN_FREQUENCY || frequency > HPCP_MAX_FREQUENCY) continue;
+            
+            float energy = magnitudes[p] * magnitudes[p];
+            auto& band = frequency < HPCP_BAND_SPLIT_FREQUENCY ? lowBand : highBand;
+            float position = size * std::log2(frequency / (float)HPCP_REFERENCE_FREQUENCY);
+            
+            for (size_t h=0; h<harmonicOffsets.size(); h++){
+                float binPosition = position + harmonicOffsets[h];
+                float below = std::floor(binPosition);
+                int step = (int)((binPosition - below) * HPCP_WINDOW_TABLE_STEPS + 0.5f);
+                
+                int bin = ((int)below + windowFirstBins[step]) % size;
+                if (bin < 0) bin += size;
+                
+                const float* w = &windowWeights[step * weights];
+                float harmonicEnergy = energy * harmonicEnergies[h];
+                for (int i=0; i<weights; i++){
+                    band[bin] += w[i] * harmonicEnergy;
+                    if (++bin == size) bin = 0;
+                }
+            }
+        }
+        
+        normalizeMax(lowBand);
+        normalizeMax(highBand);
+        hpcp.resize(size);
+        for (int i=0; i<size; i++){
+            hpcp[i] = lowBand[i] + highBand[i];
+        }
+        normalizeMax(hpcp);
+    }
+}
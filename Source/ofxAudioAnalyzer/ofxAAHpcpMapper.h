@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+///Defaults of HpcpSettings
+#define HPCP_SIZE 12
+#define HPCP_HARMONICS 0
+
+///Same ranges as Essentia's HPCP: peaks outside [min, max] are ignored, peaks below the split
+///frequency are accumulated and normalized apart from the ones above it (bandPreset) [Hz]
+#define HPCP_MIN_FREQUENCY 40.0
+#define HPCP_MAX_FREQUENCY 5000.0
+#define HPCP_BAND_SPLIT_FREQUENCY 500.0
+///Frequency of bin 0 (A) [Hz]
+#define HPCP_REFERENCE_FREQUENCY 440.0
+///Spectral peaks per frame
+#define HPCP_MAX_PEAKS 100
+///Positions of a peak between two bins in the window table: 0.1 cent steps at 12 bins, where the
+///window is only one bin wide and unitMax normalization magnifies the error of coarser steps
+#define HPCP_WINDOW_TABLE_STEPS 1024
+
+namespace ofxaa {
+    
+    struct HpcpSettings {
+        ///Bins of the HPCP: 12, 24 or 36 (any multiple of 12)
+        int size = HPCP_SIZE;
+        ///Harmonics of each peak that also contribute to the pitch class of their fundamental
+        int harmonics = HPCP_HARMONICS;
+    };
+    
+    ///Harmonic pitch class profile of a set of spectral peaks, with the model of Essentia's HPCP
+    ///(squaredCosine weighting over one semitone, bandPreset, unitMax normalization): each peak adds
+    ///its squared magnitude to the bins within half a semitone of its pitch class, weighted by
+    ///cos^2 of the distance.
+    ///
+    ///The weighting is tabulated by prepare(): the window weights for HPCP_WINDOW_TABLE_STEPS
+    ///positions of a peak between two bins (the pattern repeats every bin) and the bin offset and
+    ///strength of every harmonic. compute() then costs one log2 per peak and a few multiply-adds
+    ///per harmonic, and never allocates.
+    class HpcpMapper {
+    public:
+        ///Builds the tables. Allocates.
+        void prepare(const HpcpSettings& settings);
+        const HpcpSettings& getSettings() const { return _settings; }
+        
+        ///\param frequencies, magnitudes: spectral peaks [Hz]
+        ///\param hpcp: resized to the size of the settings (allocates only if it changed).
+        ///All 0 if no peak is in range.
+        void compute(const std::vector<float>& frequencies, const std::vector<float>& magnitudes, std::vector<float>& hpcp);
+        
+    private:
+        HpcpSettings _settings;
+        ///Bins per semitone
+        int resolution = 1;
+        
+        ///Offset [bins] and squared strength of each harmonic, the fundamental first
+        std::vector<float> harmonicOffsets;
+        std::vector<float> harmonicEnergies;
+        
+        ///For every step: the first bin of the window, relative to the bin below the peak,
+        ///and the resolution + 1 weights from there on
+        std::vector<int> windowFirstBins;
+        std::vector<float> windowWeights;
+        
+        std::vector<float> lowBand;
+        std::vector<float> highBand;
+    };
+}
@@ -28,6 +28,10 @@
 #include "ofxAANetwork.h"
 #include "ofxAAConfigurations.h"
 #include "ofxAAFactory.h"
+#include "ofxAALogger.h"
+
+#include <algorithm>
+#include <cmath>
 
 #define LOUDNESS_MAX_VALUE 100.0
 #define DYN_COMP_MAX_VALUE 50.0
@@ -56,8 +60,6 @@
 
 #define GFCC_MAX_VALUE 36000
 
-#define HPCP_SIZE 12
-
 //TODO: Remove deprecated mfcc ?
 
 namespace ofxaa {
@@ -69,8 +71,21 @@ namespace ofxaa {
         _audioSignal.resize(bufferSize);
         //_accumulatedAudioSignal.resize(bufferSize * ACCUMULATED_SIGNAL_MULTIPLIER, 0.0);
         
+        ///PitchYinFFT looks for periods up to half the frame
+        _spectrumSize = 2;
+        while (_spectrumSize < 2.0 * sr / PITCH_MIN_FREQUENCY){
+            _spectrumSize *= 2;
+        }
+        _spectralFrame.resize(_spectrumSize, 0.0);
+        spectrumComputed = false;
+        _yinPitch = 0.0;
+        _yinConfidence = 0.0;
+        
         createAlgorithms();
         connectAlgorithms();
+        setHpcpSettings(HpcpSettings());
+        createStatistics();
+        adaptiveAlgorithms.reserve(algorithms.size());
     }
     
     Network::~Network(){
@@ -88,6 +103,7 @@ namespace ofxaa {
     void Network::createAlgorithms(){
         int sr = _samplerate;
         int fs = _framesize;
+        int ss = _spectrumSize;
         
         dcRemoval = new ofxAAOneVectorOutputAlgorithm(DCRemoval, sr, fs);
         algorithms.push_back(dcRemoval);
@@ -105,7 +121,42 @@ namespace ofxaa {
         loudness->maxEstimatedValue = LOUDNESS_MAX_VALUE;
         algorithms.push_back(loudness);
         
-      
+        blockAlgorithms = algorithms;
+        
+        //MARK: SPECTRAL
+        windowing = new ofxAAOneVectorOutputAlgorithm(Windowing, sr, ss);
+        configureWindow(windowing->algorithm, true, ss, "hann", 0, true);
+        algorithms.push_back(windowing);
+        
+        spectrum = new ofxAAOneVectorOutputAlgorithm(Spectrum, sr, ss);
+        algorithms.push_back(spectrum);
+        
+        //MARK: PITCH
+        pitchYin = new ofxAABaseAlgorithm(PitchYinFFT, sr, ss);
+        configurePitchYinFFT(pitchYin->algorithm, true, std::min(PITCH_YIN_FREQ_MAX_VALUE, sr / 2.0), PITCH_MIN_FREQUENCY);
+        algorithms.push_back(pitchYin);
+        
+        pitchYinFrequency = new ofxAASingleOutputAlgorithm(PitchYinFFT);
+        pitchYinFrequency->maxEstimatedValue = PITCH_YIN_FREQ_MAX_VALUE;
+        algorithms.push_back(pitchYinFrequency);
+        
+        pitchYinConfidence = new ofxAASingleOutputAlgorithm(PitchYinFFT);
+        algorithms.push_back(pitchYinConfidence);
+        
+        //MARK: TONAL
+        spectralPeaks = new ofxAATwoVectorsOutputAlgorithm(SpectralPeaks, sr, ss);
+        configureSpectralPeaks(spectralPeaks->algorithm, 0.00001, HPCP_MAX_FREQUENCY, HPCP_MAX_PEAKS, HPCP_MIN_FREQUENCY, "magnitude");
+        algorithms.push_back(spectralPeaks);
+        
+        hpcp = new ofxAAOneVectorOutputAlgorithm(Hpcp, HPCP_SIZE);
+        hpcp->isNormalizedByDefault = true;
+        algorithms.push_back(hpcp);
+        
+        hpcpCrest = new ofxAASingleOutputAlgorithm(Crest, sr, fs);
+        algorithms.push_back(hpcpCrest);
+        
+        hpcpEntropy = new ofxAASingleOutputAlgorithm(Entropy, sr, fs);
+        algorithms.push_back(hpcpEntropy);
     }
     
     //MARK: - CONNECT ALGORITHMS
@@ -125,22 +176,260 @@ namespace ofxaa {
         loudness->algorithm->input("signal").set(dcRemoval->outputValues);
         loudness->algorithm->output("loudness").set(loudness->outputValue);
         
+        //MARK: SPECTRAL
+        windowing->algorithm->input("frame").set(_spectralFrame);
+        windowing->algorithm->output("frame").set(windowing->outputValues);
+        
+        spectrum->algorithm->input("frame").set(windowing->outputValues);
+        spectrum->algorithm->output("spectrum").set(spectrum->outputValues);
+        
+        //MARK: PITCH
+        pitchYin->algorithm->input("spectrum").set(spectrum->outputValues);
+        pitchYin->algorithm->output("pitch").set(_yinPitch);
+        pitchYin->algorithm->output("pitchConfidence").set(_yinConfidence);
+        
+        //MARK: TONAL
+        spectralPeaks->algorithm->input("spectrum").set(spectrum->outputValues);
+        spectralPeaks->algorithm->output("frequencies").set(spectralPeaks->outputValues);
+        spectralPeaks->algorithm->output("magnitudes").set(spectralPeaks->outputValues_2);
+        
+        hpcpCrest->algorithm->input("array").set(hpcp->outputValues);
+        hpcpCrest->algorithm->output("crest").set(hpcpCrest->outputValue);
+        
+        hpcpEntropy->algorithm->input("array").set(hpcp->outputValues);
+        hpcpEntropy->algorithm->output("entropy").set(hpcpEntropy->outputValue);
     }
     //MARK: - COMPUTE
     
 
-    void Network::computeAlgorithms(vector<Real>& signal){
+    void Network::computeAlgorithms(vector<Real>& signal, int numSamples){
         _audioSignal = signal;
-        for (int i=0; i<algorithms.size(); i++){
-            algorithms[i]->compute();
+        spectrumComputed = false;
+        if (updateSilenceGate()){
+            for (int i=0; i<blockAlgorithms.size(); i++){
+                blockAlgorithms[i]->compute();
+            }
+            updateSpectralFrame(dcRemoval->outputValues, numSamples);
+            computePitch();
+            computeHpcp();
+            updateAdaptiveRanges();
+            updateStatistics();
+        } else {
+            ///the constant values of silence would pull the ranges and statistics onto them
+            updateSpectralFrame(_audioSignal, numSamples);
+        }
+    }
+    
+    void Network::feedAlgorithms(vector<Real>& signal, int numSamples){
+        updateSpectralFrame(signal, numSamples);
+    }
+    
+    //MARK: - SPECTRAL
+    void Network::updateSpectralFrame(const vector<Real>& block, int numSamples){
+        auto n = std::min({(size_t)std::max(numSamples, 0), block.size(), _spectralFrame.size()});
+        std::move(_spectralFrame.begin() + n, _spectralFrame.end(), _spectralFrame.begin());
+        std::copy(block.begin(), block.begin() + n, _spectralFrame.end() - n);
+    }
+    
+    void Network::computeSpectrum(){
+        if (spectrumComputed) return;
+        windowing->compute();
+        spectrum->compute();
+        spectrumComputed = true;
+    }
+    
+    //MARK: - PITCH
+    ///Fraction of consecutive samples that change sign
+    static Real zeroCrossingRate(const vector<Real>& signal){
+        if (signal.size() < 2) return 0.0;
+        int crossings = 0;
+        for (size_t i=1; i<signal.size(); i++){
+            if ((signal[i - 1] < 0.0) != (signal[i] < 0.0)){
+                crossings++;
+            }
+        }
+        return (Real)crossings / signal.size();
+    }
+    
+    void Network::computePitch(){
+        bool frequencyActive = pitchEnabled && pitchYinFrequency->isActive;
+        bool confidenceActive = pitchEnabled && pitchYinConfidence->isActive;
+        if (!frequencyActive && !confidenceActive){
+            pitchYinFrequency->outputValue = 0.0;
+            pitchYinConfidence->outputValue = 0.0;
+            return;
+        }
+        
+        ///the frame hops by one block: a noisy block is enough to skip it
+        if (zeroCrossingRate(dcRemoval->outputValues) > pitchSettings.maxZeroCrossingRate){
+            _yinConfidence = 0.0;
+        } else {
+            computeSpectrum();
+            pitchYin->compute();
+        }
+        
+        pitchYinConfidence->outputValue = confidenceActive ? _yinConfidence : 0.0;
+        if (!frequencyActive){
+            pitchYinFrequency->outputValue = 0.0;
+        } else if (_yinConfidence >= pitchSettings.minConfidence){
+            pitchYinFrequency->outputValue = _yinPitch;
+        }
+    }
+    
+    
+    void Network::setProfiler(Profiler* profiler){
+        _profiler = profiler;
+        for (auto a : algorithms){
+            a->setProfiler(profiler);
+        }
+    }
+    
+    //MARK: - HPCP
+    void Network::setHpcpSettings(const HpcpSettings& settings){
+        hpcpMapper.prepare(settings);
+        int size = hpcpMapper.getSettings().size;
+        hpcp->outputValues.assign(size, 0.0);
+        
+        ///crest of the unitMax HPCP: 1 (flat) to size (one bin)
+        hpcpCrest->minEstimatedValue = 1.0;
+        hpcpCrest->maxEstimatedValue = size;
+        hpcpEntropy->maxEstimatedValue = std::log2((float)size);
+    }
+    
+    void Network::computeHpcp(){
+        bool hpcpActive = hpcpEnabled && hpcp->isActive;
+        bool crestActive = hpcpEnabled && hpcpCrest->isActive;
+        bool entropyActive = hpcpEnabled && hpcpEntropy->isActive;
+        if (!hpcpActive && !crestActive && !entropyActive){
+            hpcp->setSilent();
+            hpcpCrest->setSilent();
+            hpcpEntropy->setSilent();
+            return;
+        }
+        
+        computeSpectrum();
+        spectralPeaks->compute();
+        {
+#if OFXAA_ENABLE_PROFILER
+            ScopedProfile profile(_profiler, Hpcp);
+#endif
+            hpcpMapper.compute(spectralPeaks->outputValues, spectralPeaks->outputValues_2, hpcp->outputValues);
+        }
+        
+        ///Crest and Entropy need a non-zero array
+        if (*std::max_element(hpcp->outputValues.begin(), hpcp->outputValues.end()) > 0.0){
+            hpcpCrest->compute();
+            hpcpEntropy->compute();
+        } else {
+            hpcpCrest->setSilent();
+            hpcpEntropy->setSilent();
+        }
+        if (!hpcpActive){
+            hpcp->setSilent();
+        }
+    }
+    
+    //MARK: - SILENCE GATE
+    void Network::setSilenceGate(const SilenceGateSettings& settings){
+        gateSettings = settings;
+        if (!gateSettings.enabled){
+            gateOpen = true;
+            framesBelowGate = 0;
+        }
+    }
+    
+    bool Network::updateSilenceGate(){
+        if (!gateSettings.enabled) return true;
+        
+        ///lin2db() gives dbSilenceCutoff below silenceCutoff
+        float powerDb = lin2db(instantPower(_audioSignal));
+        if (powerDb >= gateSettings.openDb){
+            gateOpen = true;
+            framesBelowGate = 0;
+        } else if (powerDb < gateSettings.closeDb){
+            if (gateOpen && ++framesBelowGate >= gateSettings.holdFrames){
+                gateOpen = false;
+                for (auto a : algorithms){
+                    a->setSilent();
+                }
+            }
+        } else {
+            ///between the thresholds the gate keeps its state
+            framesBelowGate = 0;
         }
+        return gateOpen;
+    }
+    
+    //MARK: - NORMALIZATION
+    void Network::setNormalizationMode(ofxAAValue valueType, NormalizationMode mode, int adaptationFrames){
+        auto singleAlgorithm = dynamic_cast<ofxAASingleOutputAlgorithm*>(getAlgorithmWithType(valueType));
+        if (singleAlgorithm == NULL){
+            ofxaa::log("ofxAANetwork: setNormalizationMode() for a value not in the network");
+            return;
+        }
+        singleAlgorithm->setAdaptiveNormalization(mode == ADAPTIVE_NORMALIZATION, adaptationFrames);
+        
+        auto it = std::find(adaptiveAlgorithms.begin(), adaptiveAlgorithms.end(), singleAlgorithm);
+        if (mode == ADAPTIVE_NORMALIZATION && it == adaptiveAlgorithms.end()){
+            adaptiveAlgorithms.push_back(singleAlgorithm);
+        } else if (mode != ADAPTIVE_NORMALIZATION && it != adaptiveAlgorithms.end()){
+            adaptiveAlgorithms.erase(it);
+        }
+    }
+    
+    NormalizationMode Network::getNormalizationMode(ofxAAValue valueType){
+        auto singleAlgorithm = dynamic_cast<ofxAASingleOutputAlgorithm*>(getAlgorithmWithType(valueType));
+        return singleAlgorithm != NULL && singleAlgorithm->getIsAdaptiveNormalization() ? ADAPTIVE_NORMALIZATION : FIXED_NORMALIZATION;
+    }
+    
+    void Network::updateAdaptiveRanges(){
+        for (auto a : adaptiveAlgorithms){
+            if (a->isActive){
+                a->updateAdaptiveRange();
+            }
+        }
+    }
+    
+    //MARK: - STATISTICS
+    void Network::createStatistics(){
+        for (int i=0; i<NONE; i++){
+            if (getAlgorithmWithType(static_cast<ofxAAValue>(i)) != NULL){
+                statistics[i].reset(new DescriptorStatistics());
+            }
+        }
+    }
+    
+    void Network::updateStatistics(){
+        for (int i=0; i<NONE; i++){
+            if (!statisticsEnabled[i]) continue;
+            auto valueType = static_cast<ofxAAValue>(i);
+            if (getAlgorithmWithType(valueType)->isActive){
+                statistics[i]->add(getLinearValue(valueType));
+            }
+        }
+    }
+    
+    void Network::setStatisticsEnabled(ofxAAValue valueType, bool state){
+        if (valueType >= NONE || statistics[valueType] == nullptr){
+            ofxaa::log("ofxAANetwork: setStatisticsEnabled() for a value not in the network");
+            return;
+        }
+        statisticsEnabled[valueType] = state;
+    }
+    
+    bool Network::getIsStatisticsEnabled(ofxAAValue valueType) const {
+        return valueType < NONE && statisticsEnabled[valueType];
+    }
+    
+    DescriptorStatistics* Network::getStatistics(ofxAAValue valueType){
+        return valueType < NONE ? statistics[valueType].get() : NULL;
     }
     
     //MARK: - GET VALUES
     float Network::getValue(ofxAAValue value, float smooth, bool normalized){
         switch (value) {
             case NONE:
-                juce::Logger::outputDebugString("ofxAANetwork: getValue() for NONE value type");
+                ofxaa::log("ofxAANetwork: getValue() for NONE value type");
                 return 0.0;
                 
             default:
@@ -149,11 +438,21 @@ namespace ofxaa {
         }
     }
     
+    float Network::getLinearValue(ofxAAValue value){
+        auto singleAlgorithm = dynamic_cast<ofxAASingleOutputAlgorithm*>(getAlgorithmWithType(value));
+        return singleAlgorithm != NULL ? singleAlgorithm->linearValue() : 0.0;
+    }
+    
+    float Network::getNormalizedValue(ofxAAValue value){
+        auto singleAlgorithm = dynamic_cast<ofxAASingleOutputAlgorithm*>(getAlgorithmWithType(value));
+        return singleAlgorithm != NULL ? singleAlgorithm->normalizedValue() : 0.0;
+    }
+    
     vector<float>& Network::getValues(ofxAABinsValue value, float smooth, bool normalized){
         static vector<float> r(1, 0.0);
         switch (value){
             case NONE_BINS:
-                juce::Logger::outputDebugString("ofxAANetwork: getValues() for NONE_BINS type");
+                ofxaa::log("ofxAANetwork: getValues() for NONE_BINS type");
                 return r;
                 
             default:
@@ -172,8 +471,20 @@ namespace ofxaa {
             case LOUDNESS:
                 return loudness;
                 
+                //MARK: PITCH
+            case PITCH_YIN_FREQUENCY:
+                return pitchYinFrequency;
+            case PITCH_YIN_CONFIDENCE:
+                return pitchYinConfidence;
+                
+                //MARK: TONAL
+            case HPCP_CREST:
+                return hpcpCrest;
+            case HPCP_ENTROPY:
+                return hpcpEntropy;
+                
             case NONE:
-                juce::Logger::outputDebugString("ofxAANetwork: getValue() for NONE value type");
+                ofxaa::log("ofxAANetwork: getValue() for NONE value type");
                 return NULL;
                 
             default:
@@ -184,9 +495,11 @@ namespace ofxaa {
     
     ofxAAOneVectorOutputAlgorithm* Network::getAlgorithmWithType(ofxAABinsValue valueType){
         switch (valueType){
+            case HPCP:
+                return hpcp;
                 
             case NONE_BINS:
-                juce::Logger::outputDebugString("ofxAANetwork: getValues() for NONE_BINS type.");
+                ofxaa::log("ofxAANetwork: getValues() for NONE_BINS type.");
                 return NULL;
             default:
                 return NULL;
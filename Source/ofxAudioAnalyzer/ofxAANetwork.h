@@ -26,22 +26,85 @@
 
 #include "ofxAudioAnalyzerAlgorithms.h"
 #include "ofxAAValues.h"
-#include <JuceHeader.h>
+#include "ofxAAStatistics.h"
+#include "ofxAAHpcpMapper.h"
+
+#include <array>
+#include <memory>
 
 
 #define ACCUMULATED_SIGNAL_MULTIPLIER 20
+///Default window of ADAPTIVE_NORMALIZATION
+#define ADAPTIVE_NORMALIZATION_SECONDS 30.0
+
+///Defaults of SilenceGateSettings. -90 dB is Essentia's silenceCutoff (isSilent()).
+#define SILENCE_GATE_CLOSE_DB -90.0
+#define SILENCE_GATE_OPEN_DB -80.0
+#define SILENCE_GATE_HOLD_FRAMES 8
+
+///Lowest pitch PitchYinFFT looks for, sets the size of the spectral frame [Hz]
+#define PITCH_MIN_FREQUENCY 40.0
+///Defaults of PitchSettings
+#define PITCH_MIN_CONFIDENCE 0.5
+#define PITCH_MAX_ZERO_CROSSING_RATE 0.3
 
 namespace ofxaa {
+    
+    ///How a Network computes its algorithms.
+    enum NetworkBackend {
+        ///Essentia standard mode: one frame per analyzed block, computed in the calling thread.
+        STANDARD_BACKEND,
+        ///Essentia streaming mode, see StreamingNetwork.
+        STREAMING_BACKEND
+    };
+    
+    ///How normalized values are computed.
+    enum NormalizationMode {
+        ///min/max estimated values (setMaxEstimatedValue()) are 0 and 1.
+        FIXED_NORMALIZATION,
+        ///The 5th and 95th percentiles of the recent values are 0 and 1, see AdaptiveRange.
+        ADAPTIVE_NORMALIZATION
+    };
+    
+    ///Energy gate in front of the algorithms: once the power of the input (dB, lin2db) has been
+    ///below closeDb for holdFrames frames, the algorithms aren't computed and output the values
+    ///of silence (see ofxAABaseAlgorithm::setSilent()) until it rises above openDb.
+    struct SilenceGateSettings {
+        bool enabled = true;
+        float closeDb = SILENCE_GATE_CLOSE_DB;
+        float openDb = SILENCE_GATE_OPEN_DB;
+        int holdFrames = SILENCE_GATE_HOLD_FRAMES;
+    };
+    
+    ///Gating of PITCH_YIN_FREQUENCY. Blocks with a zero-crossing rate above maxZeroCrossingRate
+    ///are taken as unvoiced (noise, hats) and PitchYinFFT isn't computed: confidence is 0.
+    ///The frequency only follows frames with a confidence of at least minConfidence,
+    ///otherwise it holds the last confident pitch (0 after silence).
+    struct PitchSettings {
+        float minConfidence = PITCH_MIN_CONFIDENCE;
+        float maxZeroCrossingRate = PITCH_MAX_ZERO_CROSSING_RATE;
+    };
+    
     class Network {
     public:
         Network(int sampleRate, int bufferSize);
-        ~Network();
+        virtual ~Network();
+        
+        ///\param numSamples: new samples at the start of signal, the rest is left from earlier blocks.
+        virtual void computeAlgorithms(vector<Real>& signal, int numSamples);
+        ///Keeps the frames that span several blocks (the spectral frame) going through a block
+        ///that isn't analyzed, e.g. skipped by the governor. Nothing is computed.
+        virtual void feedAlgorithms(vector<Real>& signal, int numSamples);
         
-        void computeAlgorithms(vector<Real>& signal);
+        void setProfiler(Profiler* profiler);
         
         float getValue(ofxAAValue value, float smooth, bool normalized);
         float getValue(ofxAAValue value){ return getValue(value, 0.0, false); }
         
+        ///Unsmoothed values without side effects. Return 0.0 for values not in the network.
+        float getLinearValue(ofxAAValue value);
+        float getNormalizedValue(ofxAAValue value);
+        
         vector<float>& getValues(ofxAABinsValue value, float smooth, bool normalized);
         vector<float>& getValues(ofxAABinsValue value){ return getValues(value, 0.0, false); }
 
@@ -54,30 +117,117 @@ namespace ofxaa {
         void setMaxEstimatedValue(ofxAAValue valueType, float value);
         void setMaxEstimatedValue(ofxAABinsValue valueType, float value);
         
+        ///Not used by the STREAMING_BACKEND, its scheduler consumes every sample.
+        void setSilenceGate(const SilenceGateSettings& settings);
+        const SilenceGateSettings& getSilenceGate() const { return gateSettings; }
+        ///False while the gate skips the algorithms.
+        bool isGateOpen() const { return gateOpen; }
+        
+        ///The pitch engine (PITCH_YIN_FREQUENCY, PITCH_YIN_CONFIDENCE) runs while it's enabled
+        ///and one of its values is active. Enabled by default. Not used by the STREAMING_BACKEND.
+        void setPitchEnabled(bool state){ pitchEnabled = state; }
+        bool getIsPitchEnabled() const { return pitchEnabled; }
+        void setPitchSettings(const PitchSettings& settings){ pitchSettings = settings; }
+        const PitchSettings& getPitchSettings() const { return pitchSettings; }
+        
+        ///The HPCP engine (HPCP, HPCP_CREST, HPCP_ENTROPY) runs while it's enabled and one of its
+        ///values is active: SpectralPeaks of the spectral frame, then HpcpMapper. Enabled by
+        ///default. Not used by the STREAMING_BACKEND.
+        void setHpcpEnabled(bool state){ hpcpEnabled = state; }
+        bool getIsHpcpEnabled() const { return hpcpEnabled; }
+        ///Builds the tables of the HpcpMapper. Allocates: call before analyzing.
+        void setHpcpSettings(const HpcpSettings& settings);
+        const HpcpSettings& getHpcpSettings() const { return hpcpMapper.getSettings(); }
+        ///Samples of the spectral frame: the smallest power of two that holds two periods of PITCH_MIN_FREQUENCY.
+        int getSpectrumSize() const { return _spectrumSize; }
+        
+        ///\param adaptationFrames: time constant of ADAPTIVE_NORMALIZATION in computed frames
+        void setNormalizationMode(ofxAAValue valueType, NormalizationMode mode, int adaptationFrames);
+        NormalizationMode getNormalizationMode(ofxAAValue valueType);
+        
         //ofxAAOnsetsAlgorithm* getOnsetsPtr(){ return onsets;}
         
         ofxAABaseAlgorithm* getAlgorithmWithType(ofxAAValue valueType);
         ofxAAOneVectorOutputAlgorithm* getAlgorithmWithType(ofxAABinsValue valueType);
         
-    private:
+        ///Adds getLinearValue() of every computed frame to the statistics of the value, while its
+        ///algorithm is active. Off by default. The statistics are allocated with the network.
+        void setStatisticsEnabled(ofxAAValue valueType, bool state);
+        bool getIsStatisticsEnabled(ofxAAValue valueType) const;
+        ///NULL for values not in the network.
+        DescriptorStatistics* getStatistics(ofxAAValue valueType);
+        
+    protected:
         
         void createAlgorithms();
         
         void connectAlgorithms();
         void deleteAlgorithms();
+        void createStatistics();
+        ///Updates the gate with the power of _audioSignal, returns whether it's open.
+        bool updateSilenceGate();
+        ///Slides the first numSamples samples of the block into the spectral frame.
+        ///Called every block, even when gated or skipped.
+        void updateSpectralFrame(const vector<Real>& block, int numSamples);
+        ///Windowing and Spectrum of the spectral frame, once per block for all its consumers.
+        void computeSpectrum();
+        void computePitch();
+        void computeHpcp();
+        ///Called by computeAlgorithms() once the values of the frame are ready, not while gated.
+        void updateStatistics();
+        ///Called by computeAlgorithms() once the values of the frame are ready, not while gated.
+        void updateAdaptiveRanges();
         
         int _samplerate;
         int _framesize;
+        int _spectrumSize;
         
         vector<Real> _audioSignal;
         //vector<Real> _accumulatedAudioSignal;
         
+        ///Every wrapper of the network
         vector<ofxAABaseAlgorithm*> algorithms;
+        ///Wrappers computed on the analyzed block, in order
+        vector<ofxAABaseAlgorithm*> blockAlgorithms;
         
         ofxAAOneVectorOutputAlgorithm* dcRemoval;
         ofxAASingleOutputAlgorithm* rms;
         ofxAASingleOutputAlgorithm* power;
         ofxAASingleOutputAlgorithm* loudness;
         
+        ///Spectral front-end: the last _spectrumSize samples, hopped by every analyzed block
+        vector<Real> _spectralFrame;
+        ofxAAOneVectorOutputAlgorithm* windowing;
+        ofxAAOneVectorOutputAlgorithm* spectrum;
+        bool spectrumComputed;
+        
+        ///Computes both pitch values, which are its outputs
+        ofxAABaseAlgorithm* pitchYin;
+        ofxAASingleOutputAlgorithm* pitchYinFrequency;
+        ofxAASingleOutputAlgorithm* pitchYinConfidence;
+        Real _yinPitch;
+        Real _yinConfidence;
+        PitchSettings pitchSettings;
+        bool pitchEnabled = true;
+        
+        ofxAATwoVectorsOutputAlgorithm* spectralPeaks;
+        ///Computed by hpcpMapper
+        ofxAAOneVectorOutputAlgorithm* hpcp;
+        ofxAASingleOutputAlgorithm* hpcpCrest;
+        ofxAASingleOutputAlgorithm* hpcpEntropy;
+        HpcpMapper hpcpMapper;
+        bool hpcpEnabled = true;
+        
+        Profiler* _profiler = NULL;
+        
+        std::array<std::unique_ptr<DescriptorStatistics>, NONE> statistics;
+        std::array<bool, NONE> statisticsEnabled {};
+        
+        vector<ofxAASingleOutputAlgorithm*> adaptiveAlgorithms;
+        
+        SilenceGateSettings gateSettings;
+        bool gateOpen = true;
+        int framesBelowGate = 0;
+        
     };
 }
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAProfiler.h"
+#include "ofxAAFactory.h"
+
+#include <chrono>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+    #define OFXAA_PROFILER_TSC 1
+#endif
+
+#define CALIBRATION_NANOSECONDS 10000000
+
+namespace ofxaa {
+
+    namespace profiler {
+
+        static uint64_t steadyNanoseconds(){
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        }
+
+        uint64_t readTicks(){
+        #if defined(OFXAA_PROFILER_TSC)
+            return __rdtsc();
+        #elif defined(__aarch64__)
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+            return ticks;
+        #else
+            return steadyNanoseconds();
+        #endif
+        }
+
+        double ticksPerNanosecond(){
+            ///Measured from the first call: the longer the process runs, the better the estimate
+            static const uint64_t startTicks = readTicks();
+            static const uint64_t startNanoseconds = steadyNanoseconds();
+
+            uint64_t elapsed = steadyNanoseconds() - startNanoseconds;
+            while (elapsed < CALIBRATION_NANOSECONDS){
+                elapsed = steadyNanoseconds() - startNanoseconds;
+            }
+            return double(readTicks() - startTicks) / double(elapsed);
+        }
+    }
+
+    //----------------------------------------------
+    static int bucketForTicks(uint64_t ticks){
+        int bucket = 0;
+        while (ticks != 0 && bucket < PROFILER_BUCKETS_NUM - 1){
+            ticks >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+    //----------------------------------------------
+    void Profiler::record(int node, uint64_t startTicks, uint64_t endTicks){
+        if (node < 0 || node >= NodesNum) return;
+
+        if (traceRecorder != nullptr){
+            traceRecorder->addSpan(getNodeName(node), node < AlgorithmTypesNum ? "node" : "analyzer", startTicks, endTicks);
+        }
+        if (!isEnabled()) return;
+
+        if (resetRequested.load(std::memory_order_relaxed) && resetRequested.exchange(false)){
+            clear();
+        }
+        uint64_t ticks = endTicks > startTicks ? endTicks - startTicks : 0;
+
+        ///Single writer: plain load + store instead of read-modify-write
+        auto& n = nodes[node];
+        auto& bucket = n.buckets[bucketForTicks(ticks)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        n.totalTicks.store(n.totalTicks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+        if (ticks > n.maxTicks.load(std::memory_order_relaxed)){
+            n.maxTicks.store(ticks, std::memory_order_relaxed);
+        }
+        n.lastTicks.store(ticks, std::memory_order_relaxed);
+        n.count.store(n.count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    //----------------------------------------------
+    void Profiler::clear(){
+        for (auto& n : nodes){
+            n.count.store(0, std::memory_order_relaxed);
+            n.totalTicks.store(0, std::memory_order_relaxed);
+            n.maxTicks.store(0, std::memory_order_relaxed);
+            n.lastTicks.store(0, std::memory_order_relaxed);
+            for (auto& bucket : n.buckets){
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    //----------------------------------------------
+    NodeStats Profiler::getStats(int node) const {
+        NodeStats stats;
+        if (node < 0 || node >= NodesNum) return stats;
+
+        auto& n = nodes[node];
+        stats.count = n.count.load(std::memory_order_acquire);
+        if (stats.count == 0) return stats;
+
+        double ticksPerNs = profiler::ticksPerNanosecond();
+        double maxTicks = (double)n.maxTicks.load(std::memory_order_relaxed);
+
+        std::array<uint32_t, PROFILER_BUCKETS_NUM> buckets;
+        uint64_t histogramCount = 0;
+        for (int b=0; b<PROFILER_BUCKETS_NUM; b++){
+            buckets[b] = n.buckets[b].load(std::memory_order_relaxed);
+            histogramCount += buckets[b];
+        }
+        ///Geometric middle of the bucket, never above the max
+        auto percentileTicks = [&](double p){
+            auto rank = (uint64_t)std::ceil(p * histogramCount);
+            uint64_t cumulative = 0;
+            for (int b=0; b<PROFILER_BUCKETS_NUM; b++){
+                cumulative += buckets[b];
+                if (cumulative >= rank && cumulative > 0){
+                    return b == 0 ? 0.0 : std::min(std::pow(2.0, b - 0.5), maxTicks);
+                }
+            }
+            return maxTicks;
+        };
+
+        stats.meanNs = n.totalTicks.load(std::memory_order_relaxed) / ticksPerNs / stats.count;
+        stats.p50Ns = percentileTicks(0.50) / ticksPerNs;
+        stats.p99Ns = percentileTicks(0.99) / ticksPerNs;
+        stats.maxNs = maxTicks / ticksPerNs;
+        stats.lastNs = n.lastTicks.load(std::memory_order_relaxed) / ticksPerNs;
+        return stats;
+    }
+    //----------------------------------------------
+    const char* Profiler::getNodeName(int node){
+        if (node == FrameNode) return "Frame";
+        if (node == FramingNode) return "Framing";
+        if (node < 0 || node >= NodesNum) return "";
+        return algorithmTypeToString(static_cast<AlgorithmType>(node));
+    }
+}
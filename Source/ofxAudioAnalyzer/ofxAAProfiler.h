@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAAAlgorithmTypes.h"
+#include "ofxAATrace.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#ifndef OFXAA_ENABLE_PROFILER
+    ///Set to 0 to compile the profiling out of ofxAABaseAlgorithm::compute()
+    #define OFXAA_ENABLE_PROFILER 1
+#endif
+
+#define PROFILER_BUCKETS_NUM 64
+
+namespace ofxaa {
+
+    namespace profiler {
+        ///Raw timestamp: TSC on x86, the virtual counter on arm64, steady_clock nanoseconds elsewhere.
+        uint64_t readTicks();
+        ///Calibrated against steady_clock. The first call can take ~10ms, don't make it from the audio thread.
+        double ticksPerNanosecond();
+    }
+
+    ///Timings of one node, in nanoseconds. Percentiles come from a log2 histogram,
+    ///so they are accurate to a factor of ~1.4.
+    struct NodeStats {
+        uint64_t count = 0;
+        double meanNs = 0.0;
+        double p50Ns = 0.0;
+        double p99Ns = 0.0;
+        double maxNs = 0.0;
+        double lastNs = 0.0;
+    };
+
+    ///Per-node compute times of an ofxAudioAnalyzer. There's a node per AlgorithmType,
+    ///FrameNode for the whole analyze() call and FramingNode for copying the input into the frames.
+    ///
+    ///record() is for the analysis thread only (single writer), every other method can be called
+    ///from any thread. Nothing is recorded until setEnabled(true).
+    class Profiler {
+    public:
+        static const int FrameNode = AlgorithmTypesNum;
+        static const int FramingNode = AlgorithmTypesNum + 1;
+        static const int NodesNum = AlgorithmTypesNum + 2;
+
+        void setEnabled(bool enabled){ _enabled.store(enabled, std::memory_order_relaxed); }
+        bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+        ///Every recorded node also becomes a span of the recorder while it's enabled,
+        ///even if the profiler itself isn't. Set it before analyzing, it isn't synchronized.
+        void setTraceRecorder(TraceRecorder* recorder){ traceRecorder = recorder; }
+        TraceRecorder* getTraceRecorder() const { return traceRecorder; }
+
+        ///True if record() would do something: timing is needed.
+        bool isRecording() const { return isEnabled() || (traceRecorder != nullptr && traceRecorder->isEnabled()); }
+
+        void record(int node, uint64_t startTicks, uint64_t endTicks);
+
+        NodeStats getStats(int node) const;
+        ///Algorithm type name, "Frame" or "Framing".
+        static const char* getNodeName(int node);
+
+        ///Clears all nodes on the next record() from the analysis thread.
+        void reset(){ resetRequested.store(true, std::memory_order_relaxed); }
+
+    private:
+        struct Node {
+            std::atomic<uint64_t> count { 0 };
+            std::atomic<uint64_t> totalTicks { 0 };
+            std::atomic<uint64_t> maxTicks { 0 };
+            std::atomic<uint64_t> lastTicks { 0 };
+            ///bucket b counts durations of [2^(b-1), 2^b) ticks
+            std::array<std::atomic<uint32_t>, PROFILER_BUCKETS_NUM> buckets {};
+        };
+
+        void clear();
+
+        std::atomic<bool> _enabled { false };
+        std::atomic<bool> resetRequested { false };
+        TraceRecorder* traceRecorder = nullptr;
+        std::array<Node, NodesNum> nodes;
+    };
+
+    ///Records the lifetime of the scope in the node, if the profiler is set and enabled.
+    class ScopedProfile {
+    public:
+        ScopedProfile(Profiler* profiler, int node) : _profiler(profiler), _node(node) {
+            if (_profiler != nullptr && _profiler->isRecording()){
+                start = profiler::readTicks();
+            } else {
+                _profiler = nullptr;
+            }
+        }
+        ~ScopedProfile(){
+            if (_profiler != nullptr){
+                _profiler->record(_node, start, profiler::readTicks());
+            }
+        }
+
+        ScopedProfile(const ScopedProfile&) = delete;
+        ScopedProfile& operator=(const ScopedProfile&) = delete;
+
+    private:
+        Profiler* _profiler;
+        int _node;
+        uint64_t start = 0;
+    };
+}
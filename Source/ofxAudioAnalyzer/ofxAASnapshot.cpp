@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAASnapshot.h"
+
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<ofxaa::FrameSnapshot>::value, "FrameSnapshot is copied with memcpy");
+
+namespace ofxaa {
+
+    void SnapshotPublisher::publish(const FrameSnapshot& snapshot){
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&data, &snapshot, sizeof(FrameSnapshot));
+
+        sequence.store(seq + 2, std::memory_order_release);
+        lastFrameIndex.store(snapshot.frameIndex, std::memory_order_release);
+    }
+
+    FrameSnapshot SnapshotPublisher::read() const {
+        FrameSnapshot result;
+        while (true){
+            auto before = sequence.load(std::memory_order_acquire);
+            if (before & 1){
+                continue;
+            }
+            std::memcpy(&result, &data, sizeof(FrameSnapshot));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before){
+                return result;
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAAValues.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ofxaa {
+
+    ///Values of one descriptor for one analysis frame, averaged over all channels.
+    struct DescriptorValues {
+        ///Same as getValue(valueType, 0.0, false): linear output, dB-mapped for logarithmic algorithms.
+        float raw = 0.0;
+        ///Same as getValue(valueType, 0.0, true).
+        float normalized = 0.0;
+        ///raw and normalized after the descriptor smoothing has been applied once for this frame.
+        float smoothed = 0.0;
+        float smoothedNormalized = 0.0;
+    };
+
+    ///Immutable per-frame result of the analysis. Only subscribed descriptors are computed,
+    ///the rest keep their last values and have isSubscribed() == false.
+    struct FrameSnapshot {
+        uint64_t frameIndex = 0;
+        std::array<DescriptorValues, NONE> values {};
+        std::array<bool, NONE> subscribed {};
+
+        const DescriptorValues& get(ofxAAValue valueType) const { return values[valueType]; }
+        bool isSubscribed(ofxAAValue valueType) const { return valueType < NONE && subscribed[valueType]; }
+    };
+
+    ///Single writer / multiple readers publication of FrameSnapshots (sequence lock).
+    ///The writer never waits; readers retry only if they overlapped a publish.
+    class SnapshotPublisher {
+    public:
+        ///Call only from the thread that runs the analysis.
+        void publish(const FrameSnapshot& snapshot);
+
+        ///Can be called from any thread, any number of times, without side effects.
+        FrameSnapshot read() const;
+
+        uint64_t getLastFrameIndex() const { return lastFrameIndex.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic<uint32_t> sequence { 0 };
+        std::atomic<uint64_t> lastFrameIndex { 0 };
+        FrameSnapshot data;
+    };
+}
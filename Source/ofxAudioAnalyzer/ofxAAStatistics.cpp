@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ofxaa {
+    
+    static const double logGamma = std::log((1.0 + STATISTICS_SKETCH_ACCURACY) / (1.0 - STATISTICS_SKETCH_ACCURACY));
+    static const int firstIndex = (int)std::ceil(std::log(STATISTICS_SKETCH_MIN_VALUE) / logGamma);
+    
+    static int bucketFor(float magnitude){
+        int index = (int)std::ceil(std::log(magnitude) / logGamma);
+        return std::min(std::max(index - firstIndex, 0), STATISTICS_SKETCH_BUCKETS - 1);
+    }
+    //----------------------------------------------
+    static float valueOf(int bucket){
+        ///the value with the same relative distance to both bucket bounds
+        double gamma = std::exp(logGamma);
+        return (float)(2.0 * std::pow(gamma, bucket + firstIndex) / (gamma + 1.0));
+    }
+    
+    //MARK: - QuantileSketch
+    
+
+    void QuantileSketch::Store::add(int bucket, uint32_t n){
+        counts[bucket] += n;
+        lowest = std::min(lowest, bucket);
+        highest = std::max(highest, bucket);
+    }
+    //----------------------------------------------
+    void QuantileSketch::Store::clear(){
+        if (lowest <= highest){
+            std::fill(counts.begin() + lowest, counts.begin() + highest + 1, 0);
+        }
+        lowest = STATISTICS_SKETCH_BUCKETS;
+        highest = -1;
+    }
+    //----------------------------------------------
+    void QuantileSketch::add(float value){
+        if (std::isnan(value)) return;
+        float magnitude = std::fabs(value);
+        if (magnitude < STATISTICS_SKETCH_MIN_VALUE){
+            zeros++;
+        } else if (value > 0){
+            positive.add(bucketFor(magnitude), 1);
+        } else {
+            negative.add(bucketFor(magnitude), 1);
+        }
+        count++;
+    }
+    //----------------------------------------------
+    void QuantileSketch::merge(const QuantileSketch& other){
+        for (int i=other.positive.lowest; i<=other.positive.highest; i++){
+            if (other.positive.counts[i] > 0) positive.add(i, other.positive.counts[i]);
+        }
+        for (int i=other.negative.lowest; i<=other.negative.highest; i++){
+            if (other.negative.counts[i] > 0) negative.add(i, other.negative.counts[i]);
+        }
+        zeros += other.zeros;
+        count += other.count;
+    }
+    //----------------------------------------------
+    void QuantileSketch::clear(){
+        positive.clear();
+        negative.clear();
+        zeros = 0;
+        count = 0;
+    }
+    //----------------------------------------------
+    float QuantileSketch::getQuantile(double quantile) const {
+        if (count == 0) return 0.0;
+        double rank = std::min(std::max(quantile, 0.0), 1.0) * (count - 1);
+        
+        ///ascending values: negatives from the largest magnitude, zeros, positives
+        uint64_t seen = 0;
+        for (int i=negative.highest; i>=negative.lowest; i--){
+            seen += negative.counts[i];
+            if (seen > rank) return -valueOf(i);
+        }
+        seen += zeros;
+        if (seen > rank) return 0.0;
+        for (int i=positive.lowest; i<=positive.highest; i++){
+            seen += positive.counts[i];
+            if (seen > rank) return valueOf(i);
+        }
+        return positive.highest >= 0 ? valueOf(positive.highest) : 0.0;
+    }
+    
+    //MARK: - DescriptorStatistics
+    
+    void DescriptorStatistics::add(float value){
+        if (std::isnan(value)) return;
+        count++;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        min = count == 1 ? value : std::min(min, value);
+        max = count == 1 ? value : std::max(max, value);
+        sketch.add(value);
+    }
+    //----------------------------------------------
+    void DescriptorStatistics::merge(const DescriptorStatistics& other){
+        if (other.count == 0) return;
+        if (count == 0){
+            count = other.count;
+            mean = other.mean;
+            m2 = other.m2;
+            min = other.min;
+            max = other.max;
+        } else {
+            ///Chan et al. parallel combination
+            uint64_t total = count + other.count;
+            double delta = other.mean - mean;
+            mean += delta * other.count / total;
+            m2 += other.m2 + delta * delta * ((double)count * other.count / total);
+            count = total;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+        }
+        sketch.merge(other.sketch);
+    }
+    //----------------------------------------------
+    void DescriptorStatistics::clear(){
+        count = 0;
+        mean = 0.0;
+        m2 = 0.0;
+        min = 0.0;
+        max = 0.0;
+        sketch.clear();
+    }
+    //----------------------------------------------
+    float DescriptorStatistics::getVariance() const {
+        return count > 1 ? (float)(m2 / count) : 0.0;
+    }
+    //----------------------------------------------
+    float DescriptorStatistics::getStandardDeviation() const {
+        return std::sqrt(getVariance());
+    }
+    //----------------------------------------------
+    float DescriptorStatistics::getQuantile(double quantile) const {
+        if (count == 0) return 0.0;
+        return std::min(std::max(sketch.getQuantile(quantile), min), max);
+    }
+    
+    //MARK: - AdaptiveRange
+    
+    ///Rescale the weights before they overflow
+    #define ADAPTIVE_RANGE_MAX_WEIGHT 1e200
+    
+    static int signedBucketFor(float value){
+        float magnitude = std::fabs(value);
+        if (magnitude < STATISTICS_SKETCH_MIN_VALUE) return STATISTICS_SKETCH_BUCKETS;
+        int bucket = bucketFor(magnitude);
+        return value > 0 ? STATISTICS_SKETCH_BUCKETS + 1 + bucket : STATISTICS_SKETCH_BUCKETS - 1 - bucket;
+    }
+    //----------------------------------------------
+    static float signedValueOf(int bucket){
+        if (bucket > STATISTICS_SKETCH_BUCKETS) return valueOf(bucket - STATISTICS_SKETCH_BUCKETS - 1);
+        if (bucket < STATISTICS_SKETCH_BUCKETS) return -valueOf(STATISTICS_SKETCH_BUCKETS - 1 - bucket);
+        return 0.0;
+    }
+    //----------------------------------------------
+    void AdaptiveRange::setAdaptationFrames(int frames){
+        adaptationFrames = std::max(frames, 1);
+        growth = std::exp(1.0 / adaptationFrames);
+        clear();
+    }
+    //----------------------------------------------
+    void AdaptiveRange::clear(){
+        weights.fill(0.0);
+        weight = 1.0;
+        total = 0.0;
+        for (auto cursor : { &low, &high }){
+            cursor->bucket = 0;
+            cursor->below = 0.0;
+            cursor->value = 0.0;
+        }
+    }
+    //----------------------------------------------
+    void AdaptiveRange::add(float value){
+        if (std::isnan(value)) return;
+        
+        ///newer values weigh more, which is the same as older values decaying
+        weight *= growth;
+        if (weight > ADAPTIVE_RANGE_MAX_WEIGHT){
+            rescale();
+        }
+        int bucket = signedBucketFor(value);
+        weights[bucket] += weight;
+        total += weight;
+        
+        moveCursor(low, bucket, weight);
+        moveCursor(high, bucket, weight);
+    }
+    //----------------------------------------------
+    void AdaptiveRange::moveCursor(Cursor& cursor, int addedBucket, double addedWeight){
+        if (addedBucket < cursor.bucket){
+            cursor.below += addedWeight;
+        }
+        ///the cursor bucket holds the target: below <= target < below + weights[bucket]
+        double target = cursor.quantile * total;
+        while (cursor.bucket > 0 && cursor.below > target){
+            cursor.bucket--;
+            cursor.below -= weights[cursor.bucket];
+        }
+        while (cursor.bucket < BucketsNum - 1 && cursor.below + weights[cursor.bucket] <= target){
+            cursor.below += weights[cursor.bucket];
+            cursor.bucket++;
+        }
+        cursor.value = signedValueOf(cursor.bucket);
+    }
+    //----------------------------------------------
+    void AdaptiveRange::rescale(){
+        ///also recomputes the sums the cursors accumulated
+        double scale = 1.0 / weight;
+        total = 0.0;
+        low.below = high.below = 0.0;
+        for (int i=0; i<BucketsNum; i++){
+            weights[i] *= scale;
+            if (i < low.bucket) low.below += weights[i];
+            if (i < high.bucket) high.below += weights[i];
+            total += weights[i];
+        }
+        weight = 1.0;
+    }
+    //----------------------------------------------
+    float AdaptiveRange::map(float value) const {
+        float range = high.value - low.value;
+        if (total == 0.0 || range <= 0.0) return 0.0;
+        return std::min(std::max((value - low.value) / range, 0.0f), 1.0f);
+    }
+}
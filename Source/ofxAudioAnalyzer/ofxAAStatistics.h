@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+///Relative error of the quantiles of a QuantileSketch
+#define STATISTICS_SKETCH_ACCURACY 0.02
+///Buckets per sign, enough for magnitudes from STATISTICS_SKETCH_MIN_VALUE to ~1e9 at 2%
+#define STATISTICS_SKETCH_BUCKETS 1024
+///Magnitudes below this are counted as zero
+#define STATISTICS_SKETCH_MIN_VALUE 1e-9
+
+///Quantiles an AdaptiveRange maps to 0 and 1
+#define ADAPTIVE_RANGE_LOW_QUANTILE 0.05
+#define ADAPTIVE_RANGE_HIGH_QUANTILE 0.95
+
+namespace ofxaa {
+    
+    ///Approximate quantiles in fixed memory (DDSketch): values are counted in logarithmic
+    ///buckets, so every quantile is within STATISTICS_SKETCH_ACCURACY of the exact value
+    ///(relative to it). Magnitudes outside the bucket range fall into the first or last bucket.
+    ///Sketches of the same values in any split merge into the sketch of all of them.
+    class QuantileSketch {
+    public:
+        void add(float value);
+        void merge(const QuantileSketch& other);
+        void clear();
+        
+        uint64_t getCount() const { return count; }
+        ///\param quantile: 0.0 to 1.0. Returns 0.0 if empty.
+        float getQuantile(double quantile) const;
+        
+    private:
+        ///Counts of one sign, with the range of buckets in use so merge() and clear() only
+        ///touch those.
+        struct Store {
+            std::array<uint32_t, STATISTICS_SKETCH_BUCKETS> counts {};
+            int lowest = STATISTICS_SKETCH_BUCKETS;
+            int highest = -1;
+            
+            void add(int bucket, uint32_t n);
+            void clear();
+        };
+        
+        Store positive;
+        Store negative;
+        uint64_t zeros = 0;
+        uint64_t count = 0;
+    };
+    
+    ///Running statistics of one descriptor: count, mean and variance (Welford), min, max and
+    ///quantiles (QuantileSketch). add() is O(1); merge() combines the statistics of other
+    ///channels, instances or chunks of the same material.
+    class DescriptorStatistics {
+    public:
+        void add(float value);
+        void merge(const DescriptorStatistics& other);
+        void clear();
+        
+        uint64_t getCount() const { return count; }
+        float getMean() const { return (float)mean; }
+        ///Population variance, 0.0 with less than two values.
+        float getVariance() const;
+        float getStandardDeviation() const;
+        float getMin() const { return count > 0 ? min : 0.0; }
+        float getMax() const { return count > 0 ? max : 0.0; }
+        ///Approximate quantile, clamped to [getMin(), getMax()].
+        ///\param quantile: 0.0 to 1.0
+        float getQuantile(double quantile) const;
+        
+    private:
+        uint64_t count = 0;
+        double mean = 0.0;
+        ///Sum of squared differences from the mean
+        double m2 = 0.0;
+        float min = 0.0;
+        float max = 0.0;
+        QuantileSketch sketch;
+    };
+    
+    ///Recent range of a descriptor: the ADAPTIVE_RANGE_LOW_QUANTILE and ADAPTIVE_RANGE_HIGH_QUANTILE
+    ///of its values, each weighted by exp(-age / adaptationFrames). Uses the buckets of a
+    ///QuantileSketch (2% relative error) with weights that grow instead of decaying, and follows
+    ///both quantiles with cursors, so memory is constant and add() is amortized O(1).
+    class AdaptiveRange {
+    public:
+        AdaptiveRange(){ setAdaptationFrames(1); }
+        
+        ///Time constant of the window, clears the range.
+        void setAdaptationFrames(int frames);
+        int getAdaptationFrames() const { return adaptationFrames; }
+        
+        void add(float value);
+        void clear();
+        
+        float getLow() const { return low.value; }
+        float getHigh() const { return high.value; }
+        ///Maps [getLow(), getHigh()] to [0, 1], clamped. 0.0 while the range is empty.
+        float map(float value) const;
+        
+    private:
+        ///Buckets in ascending order of value: negatives, zero, positives
+        static const int BucketsNum = 2 * STATISTICS_SKETCH_BUCKETS + 1;
+        
+        ///Bucket of the quantile, with the total weight of the buckets below it
+        struct Cursor {
+            double quantile;
+            int bucket = 0;
+            double below = 0.0;
+            float value = 0.0;
+        };
+        
+        void moveCursor(Cursor& cursor, int addedBucket, double addedWeight);
+        void rescale();
+        
+        std::array<double, BucketsNum> weights {};
+        int adaptationFrames = 1;
+        double growth = 1.0;
+        double weight = 1.0;
+        double total = 0.0;
+        Cursor low { ADAPTIVE_RANGE_LOW_QUANTILE };
+        Cursor high { ADAPTIVE_RANGE_HIGH_QUANTILE };
+    };
+}
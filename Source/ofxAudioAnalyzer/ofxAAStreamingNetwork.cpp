@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAAStreamingNetwork.h"
+#include "ofxAAFactory.h"
+#include "ofxAALogger.h"
+
+#include "streaming/algorithms/ringbufferinput.h"
+#include "streaming/algorithms/ringbufferoutput.h"
+#include "scheduler/network.h"
+
+#include <chrono>
+
+namespace ofxaa {
+    
+    StreamingNetwork::StreamingNetwork(int sr, int bufferSize, int frameSize, int hopSize) : Network(sr, bufferSize){
+        _streamingFrameSize = frameSize > 0 ? frameSize : bufferSize;
+        _streamingHopSize = hopSize > 0 ? hopSize : _streamingFrameSize;
+        ringInput = NULL;
+        scheduler = NULL;
+        framesCount = 0;
+        drainBuffer.resize(STREAMING_RING_BUFFER_SIZE);
+        
+        createStreamingNetwork();
+        schedulerThread = std::thread(&StreamingNetwork::runScheduler, this);
+    }
+    //----------------------------------------------
+    StreamingNetwork::~StreamingNetwork(){
+        stopRequested = true;
+        
+        ///The scheduler can be waiting for input or for room in an output: keep feeding it
+        ///silence and draining it until it sees the stop request.
+        vector<Real> silence(_streamingHopSize, 0.0);
+        while (!schedulerFinished){
+            ringInput->add(silence.data(), (int)silence.size());
+            drainOutputs();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        schedulerThread.join();
+        
+        ///deletes every streaming algorithm of the graph
+        delete scheduler;
+    }
+    
+    bool StreamingNetwork::computesValue(ofxAAValue value){
+        ///the descriptors of createStreamingNetwork()
+        return value == RMS || value == POWER || value == LOUDNESS;
+    }
+    
+    //MARK: - CREATE
+    void StreamingNetwork::createStreamingNetwork(){
+        auto& factory = streaming::AlgorithmFactory::instance();
+        
+        auto input = factory.create("RingBufferInput", "bufferSize", STREAMING_RING_BUFFER_SIZE);
+        ringInput = static_cast<streaming::RingBufferInput*>(input);
+        
+        auto dc = factory.create(algorithmTypeToString(DCRemoval), "sampleRate", _samplerate);
+        auto frameCutter = factory.create("FrameCutter",
+                                          "frameSize", _streamingFrameSize,
+                                          "hopSize", _streamingHopSize,
+                                          "startFromZero", true);
+        
+        streaming::connect(input->output("signal"), dc->input("signal"));
+        streaming::connect(dc->output("signal"), frameCutter->input("signal"));
+        
+        ///descriptor, its input and output names: same as connectAlgorithms()
+        struct Descriptor {
+            ofxAASingleOutputAlgorithm* algorithm;
+            const char* input;
+            const char* output;
+        };
+        vector<Descriptor> descriptors {
+            { rms, "array", "rms" },
+            { power, "array", "power" },
+            { loudness, "signal", "loudness" }
+        };
+        
+        for (auto& descriptor : descriptors){
+            auto algorithm = factory.create(algorithmTypeToString(descriptor.algorithm->getType()));
+            auto output = factory.create("RingBufferOutput", "bufferSize", STREAMING_RING_BUFFER_SIZE);
+            streaming::connect(frameCutter->output("frame"), algorithm->input(descriptor.input));
+            streaming::connect(algorithm->output(descriptor.output), output->input("signal"));
+            outputs.push_back({ descriptor.algorithm, static_cast<streaming::RingBufferOutput*>(output) });
+        }
+        
+        scheduler = new essentia::scheduler::Network(input);
+    }
+    
+    //MARK: - SCHEDULER THREAD
+    void StreamingNetwork::runScheduler(){
+        try {
+            scheduler->runPrepare();
+            while (!stopRequested){
+                if (!scheduler->runStep()) break;
+            }
+        } catch (const std::exception& e){
+            ofxaa::log((string("ofxAAStreamingNetwork: ") + e.what()).c_str());
+        }
+        schedulerFinished = true;
+    }
+    
+    //MARK: - COMPUTE
+    void StreamingNetwork::computeAlgorithms(vector<Real>& signal, int numSamples){
+        feedAlgorithms(signal, numSamples);
+        drainOutputs();
+        updateAdaptiveRanges();
+        updateStatistics();
+    }
+    //----------------------------------------------
+    void StreamingNetwork::feedAlgorithms(vector<Real>& signal, int numSamples){
+        if (!schedulerFinished){
+            ringInput->add(signal.data(), std::min(numSamples, (int)signal.size()));
+        }
+    }
+    //----------------------------------------------
+    void StreamingNetwork::drainOutputs(){
+        uint64_t frames = 0;
+        for (auto& output : outputs){
+            int count = output.ring->get(drainBuffer.data(), (int)drainBuffer.size());
+            if (count > 0){
+                output.algorithm->outputValue = output.algorithm->isActive ? drainBuffer[count - 1] : 0.0;
+                frames = std::max<uint64_t>(frames, count);
+            }
+        }
+        framesCount += frames;
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAANetwork.h"
+
+#include <atomic>
+#include <thread>
+
+namespace essentia {
+    namespace streaming {
+        class RingBufferInput;
+        class RingBufferOutput;
+    }
+    namespace scheduler {
+        class Network;
+    }
+}
+
+///Samples of audio, and values of each descriptor, that can wait between the two threads.
+#define STREAMING_RING_BUFFER_SIZE 65536
+
+namespace ofxaa {
+    ///Network computed by Essentia's streaming scheduler instead of calling compute() on each algorithm.
+    ///
+    ///Analyzed blocks are pushed into a RingBufferInput; a scheduler thread runs
+    ///DCRemoval -> FrameCutter -> descriptors and every descriptor writes one value per frame into
+    ///its RingBufferOutput. computeAlgorithms() pushes the block and takes the latest values, so the
+    ///framing (frameSize, hopSize) doesn't depend on the host block size.
+    ///
+    ///Values lag the pushed audio by the framing and the buffering of the streaming algorithms.
+    ///The ring buffers lock a mutex: use it for offline analysis and experiments, the plug-in
+    ///keeps the standard backend. Inactive algorithms read 0.0 but are still computed.
+    ///
+    ///The ofxAABaseAlgorithm wrappers of Network are kept for their estimated ranges, value
+    ///mapping and smoothing; their standard algorithms aren't computed.
+    ///The pitch and HPCP engines aren't part of the streaming graph: only the values of
+    ///computesValue() are computed, ofxAudioAnalyzer::subscribe() rejects the others.
+    class StreamingNetwork : public Network {
+    public:
+        ///\param frameSize, hopSize: framing of the descriptors, 0 for bufferSize
+        StreamingNetwork(int sampleRate, int bufferSize, int frameSize, int hopSize);
+        ~StreamingNetwork() override;
+        
+        void computeAlgorithms(vector<Real>& signal, int numSamples) override;
+        ///Pushes the block without taking any value, so the framing stays continuous.
+        void feedAlgorithms(vector<Real>& signal, int numSamples) override;
+        
+        ///True for the values of the streaming graph (RMS, POWER, LOUDNESS).
+        static bool computesValue(ofxAAValue value);
+        ///No vector output is part of the streaming graph.
+        static bool computesValue(ofxAABinsValue) { return false; }
+        
+        ///Frames computed by the scheduler so far.
+        uint64_t getFramesCount() const { return framesCount; }
+        
+    private:
+        void createStreamingNetwork();
+        void runScheduler();
+        void drainOutputs();
+        
+        struct Output {
+            ofxAASingleOutputAlgorithm* algorithm;
+            essentia::streaming::RingBufferOutput* ring;
+        };
+        
+        int _streamingFrameSize;
+        int _streamingHopSize;
+        
+        essentia::streaming::RingBufferInput* ringInput;
+        vector<Output> outputs;
+        vector<Real> drainBuffer;
+        uint64_t framesCount;
+        
+        essentia::scheduler::Network* scheduler;
+        std::thread schedulerThread;
+        std::atomic<bool> stopRequested { false };
+        std::atomic<bool> schedulerFinished { false };
+    };
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "ofxAATrace.h"
+#include "ofxAAProfiler.h"
+
+#include <vector>
+
+namespace ofxaa {
+
+    ///Small sequential ids, Chrome shows one track per thread
+    static uint32_t currentThreadId(){
+        static std::atomic<uint32_t> nextId { 1 };
+        thread_local uint32_t id = nextId.fetch_add(1);
+        return id;
+    }
+    //----------------------------------------------
+    static void writeJsonString(std::ostream& stream, const char* text){
+        stream << '"';
+        for (auto c = text; c != nullptr && *c != 0; c++){
+            if (*c == '"' || *c == '\\') stream << '\\';
+            stream << *c;
+        }
+        stream << '"';
+    }
+    //----------------------------------------------
+    TraceRecorder::TraceRecorder(size_t capacity){
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        spans.reset(new Span[size]);
+    }
+    //----------------------------------------------
+    void TraceRecorder::addSpan(const char* name, const char* category, uint64_t startTicks, uint64_t endTicks){
+        if (!isEnabled()) return;
+
+        auto index = writeIndex.load(std::memory_order_relaxed);
+        auto& span = spans[index & mask];
+
+        ///Per slot sequence lock: odd while writing, 2*(index+1) once span holds entry `index`
+        span.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        span.name = name;
+        span.category = category;
+        span.startTicks = startTicks;
+        span.durationTicks = endTicks > startTicks ? endTicks - startTicks : 0;
+        span.threadId = currentThreadId();
+
+        span.sequence.store(2 * index + 2, std::memory_order_release);
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+    //----------------------------------------------
+    void TraceRecorder::clear(){
+        writeIndex.store(0);
+        for (size_t i=0; i<=mask; i++){
+            spans[i].sequence.store(0);
+        }
+    }
+    //----------------------------------------------
+    void TraceRecorder::writeChromeJson(std::ostream& stream, int processId, const char* processName) const {
+        struct Copy {
+            const char* name;
+            const char* category;
+            uint64_t startTicks;
+            uint64_t durationTicks;
+            uint32_t threadId;
+        };
+
+        auto end = writeIndex.load(std::memory_order_acquire);
+        auto begin = end > mask + 1 ? end - (mask + 1) : 0;
+
+        std::vector<Copy> copies;
+        copies.reserve(end - begin);
+        for (auto index = begin; index < end; index++){
+            auto& span = spans[index & mask];
+            auto before = span.sequence.load(std::memory_order_acquire);
+            if (before != 2 * index + 2) continue;
+
+            Copy copy { span.name, span.category, span.startTicks, span.durationTicks, span.threadId };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (span.sequence.load(std::memory_order_relaxed) != before) continue;
+
+            copies.push_back(copy);
+        }
+
+        ///Timestamps are absolute, so traces of several instances line up when merged
+        double ticksPerMicrosecond = profiler::ticksPerNanosecond() * 1000.0;
+
+        auto previousPrecision = stream.precision(3);
+        auto previousFlags = stream.setf(std::ios::fixed, std::ios::floatfield);
+
+        stream << "{\"traceEvents\":[\n";
+        stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << processId << ",\"args\":{\"name\":";
+        writeJsonString(stream, processName);
+        stream << "}}";
+        for (auto& copy : copies){
+            stream << ",\n{\"name\":";
+            writeJsonString(stream, copy.name);
+            stream << ",\"cat\":";
+            writeJsonString(stream, copy.category);
+            stream << ",\"ph\":\"X\",\"ts\":" << copy.startTicks / ticksPerMicrosecond
+                   << ",\"dur\":" << copy.durationTicks / ticksPerMicrosecond
+                   << ",\"pid\":" << processId
+                   << ",\"tid\":" << copy.threadId << "}";
+        }
+        stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+        stream.precision(previousPrecision);
+        stream.flags(previousFlags);
+    }
+
+    //MARK: - ScopedTraceSpan
+
+    ScopedTraceSpan::ScopedTraceSpan(TraceRecorder* recorder, const char* name, const char* category)
+        : _recorder(recorder), _name(name), _category(category) {
+        if (_recorder != nullptr && _recorder->isEnabled()){
+            start = profiler::readTicks();
+        } else {
+            _recorder = nullptr;
+        }
+    }
+    //----------------------------------------------
+    ScopedTraceSpan::~ScopedTraceSpan(){
+        if (_recorder != nullptr){
+            _recorder->addSpan(_name, _category, start, profiler::readTicks());
+        }
+    }
+}
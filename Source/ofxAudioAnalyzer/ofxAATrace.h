@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#define TRACE_DEFAULT_CAPACITY 65536
+
+namespace ofxaa {
+
+    ///Records timed spans into a preallocated ring buffer and writes them in the Chrome trace
+    ///event format (chrome://tracing, ui.perfetto.dev). When the buffer is full the oldest
+    ///spans are overwritten.
+    ///
+    ///addSpan() is for one recording thread at a time (the audio thread) and never allocates or
+    ///blocks. writeChromeJson() can be called from any thread while recording, spans overwritten
+    ///during the copy are left out.
+    class TraceRecorder {
+    public:
+        ///\param capacity: number of spans kept, rounded up to a power of two.
+        explicit TraceRecorder(size_t capacity = TRACE_DEFAULT_CAPACITY);
+
+        void setEnabled(bool enabled){ _enabled.store(enabled, std::memory_order_relaxed); }
+        bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+        ///\param name, category: must outlive the recorder (string literals, algorithm type names).
+        ///\param startTicks, endTicks: profiler::readTicks() timestamps.
+        void addSpan(const char* name, const char* category, uint64_t startTicks, uint64_t endTicks);
+
+        ///Writes {"traceEvents": [...]} with the spans currently in the buffer.
+        ///\param processId: shown as a separate process per instance when traces are merged.
+        ///\param processName: label of that process, can be empty.
+        void writeChromeJson(std::ostream& stream, int processId = 1, const char* processName = "") const;
+
+        ///Drops the recorded spans. Don't call while addSpan() may run.
+        void clear();
+
+    private:
+        struct Span {
+            std::atomic<uint64_t> sequence { 0 };
+            const char* name = nullptr;
+            const char* category = nullptr;
+            uint64_t startTicks = 0;
+            uint64_t durationTicks = 0;
+            uint32_t threadId = 0;
+        };
+
+        std::atomic<bool> _enabled { false };
+        std::atomic<uint64_t> writeIndex { 0 };
+        size_t mask;
+        std::unique_ptr<Span[]> spans;
+    };
+
+    ///Adds a span for the lifetime of the scope, if the recorder is set and enabled.
+    class ScopedTraceSpan {
+    public:
+        ScopedTraceSpan(TraceRecorder* recorder, const char* name, const char* category = "plugin");
+        ~ScopedTraceSpan();
+
+        ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+        ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+    private:
+        TraceRecorder* _recorder;
+        const char* _name;
+        const char* _category;
+        uint64_t start = 0;
+    };
+}
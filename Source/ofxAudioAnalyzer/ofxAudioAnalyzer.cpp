@@ -23,7 +23,15 @@
  */
 
 #include "ofxAudioAnalyzer.h"
+#include "ofxAALogger.h"
+#include "ofxAAStreamingNetwork.h"
 
+//-------------------------------------------------------
+ofxAudioAnalyzer::~ofxAudioAnalyzer(){
+    for (auto unit : channelAnalyzerUnits){
+        delete unit;
+    }
+}
 //-------------------------------------------------------
 void ofxAudioAnalyzer::setup(int sampleRate, int bufferSize, int channels){
     
@@ -32,7 +40,7 @@ void ofxAudioAnalyzer::setup(int sampleRate, int bufferSize, int channels){
     _channels = channels;
     
     if(_channels <= 0){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: channels cant be set to none. Setting 1 channel");
+        ofxaa::log("ofxAudioAnalyzer: channels cant be set to none. Setting 1 channel");
         _channels = 1;
     }
     
@@ -41,9 +49,17 @@ void ofxAudioAnalyzer::setup(int sampleRate, int bufferSize, int channels){
     }
     
     for(int i=0; i<_channels; i++){
-        ofxAudioAnalyzerUnit * aaUnit = new ofxAudioAnalyzerUnit(_samplerate, _buffersize);
+        ofxAudioAnalyzerUnit * aaUnit = new ofxAudioAnalyzerUnit(_samplerate, _buffersize, _backend, _streamingFrameSize, _streamingHopSize);
+        aaUnit->setProfiler(&profiler);
+        aaUnit->setSilenceGate(_silenceGate);
+        aaUnit->setPitchSettings(_pitchSettings);
+        aaUnit->setHpcpSettings(_hpcpSettings);
         channelAnalyzerUnits.push_back(aaUnit);
     }
+    
+    ///new units use FIXED_NORMALIZATION, updateNormalizationModes() applies the modes again
+    appliedAdaptationSeconds.fill(0.0);
+    createStatistics();
 }
 //-------------------------------------------------------
 void ofxAudioAnalyzer::reset(int sampleRate, int bufferSize, int channels){
@@ -53,46 +69,419 @@ void ofxAudioAnalyzer::reset(int sampleRate, int bufferSize, int channels){
     _channels = channels;
     
     if(_channels <= 0){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: channels cant be set to none. Setting 1 channel");
+        ofxaa::log("ofxAudioAnalyzer: channels cant be set to none. Setting 1 channel");
         _channels = 1;
     }
     
     for (int i=0; i<channelAnalyzerUnits.size(); i++){
-        channelAnalyzerUnits[i]->exit();
+        delete channelAnalyzerUnits[i];
     }
     channelAnalyzerUnits.clear();
     
     for(int i=0; i<_channels; i++){
-        ofxAudioAnalyzerUnit * aaUnit = new ofxAudioAnalyzerUnit(_samplerate, _buffersize);
+        ofxAudioAnalyzerUnit * aaUnit = new ofxAudioAnalyzerUnit(_samplerate, _buffersize, _backend, _streamingFrameSize, _streamingHopSize);
+        aaUnit->setProfiler(&profiler);
+        aaUnit->setSilenceGate(_silenceGate);
+        aaUnit->setPitchSettings(_pitchSettings);
+        aaUnit->setHpcpSettings(_hpcpSettings);
         channelAnalyzerUnits.push_back(aaUnit);
     }
     
     loadStoredMaxEstimatedValues();
+    appliedAdaptationSeconds.fill(0.0);
+    createStatistics();
 }
 //-------------------------------------------------------
-void ofxAudioAnalyzer::analyze(const juce::AudioBuffer<float>& buffer){
-   
-    if(buffer.getNumChannels() != _channels){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: inBuffer channels number incorrect.");
-        return;
+void ofxAudioAnalyzer::setBackend(ofxaa::NetworkBackend backend, int frameSize, int hopSize){
+    _backend = backend;
+    _streamingFrameSize = frameSize;
+    _streamingHopSize = hopSize;
+    for (int i=0; i<NONE; i++){
+        if (subscriptions[i].load() > 0 && !isComputed(static_cast<ofxAAValue>(i))){
+            ofxaa::log("ofxAudioAnalyzer: the backend doesn't compute a subscribed value, unsubscribed");
+            subscriptions[i].store(0);
+        }
+    }
+    for (int i=0; i<NONE_BINS; i++){
+        if (binsSubscriptions[i].load() > 0 && !isComputed(static_cast<ofxAABinsValue>(i))){
+            ofxaa::log("ofxAudioAnalyzer: the backend doesn't compute a subscribed value, unsubscribed");
+            binsSubscriptions[i].store(0);
+        }
+    }
+    for (int i=0; i<NONE; i++){
+        if (statisticsRequests[i].load() > 0 && !isComputed(static_cast<ofxAAValue>(i))){
+            ofxaa::log("ofxAudioAnalyzer: the backend doesn't compute a value with statistics enabled, disabled");
+            statisticsRequests[i].store(0);
+        }
+    }
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::isComputed(ofxAAValue valueType) const {
+    return _backend != ofxaa::STREAMING_BACKEND || ofxaa::StreamingNetwork::computesValue(valueType);
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::isComputed(ofxAABinsValue valueType) const {
+    return _backend != ofxaa::STREAMING_BACKEND || ofxaa::StreamingNetwork::computesValue(valueType);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::setSilenceGate(const ofxaa::SilenceGateSettings& settings){
+    _silenceGate = settings;
+    for (auto unit : channelAnalyzerUnits){
+        unit->setSilenceGate(settings);
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::setPitchSettings(const ofxaa::PitchSettings& settings){
+    _pitchSettings = settings;
+    for (auto unit : channelAnalyzerUnits){
+        unit->setPitchSettings(settings);
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::setHpcpSettings(const ofxaa::HpcpSettings& settings){
+    _hpcpSettings = settings;
+    for (auto unit : channelAnalyzerUnits){
+        unit->setHpcpSettings(settings);
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::updateSpectralEngines(){
+    bool pitchEnabled = isSubscribed(PITCH_YIN_FREQUENCY) || isSubscribed(PITCH_YIN_CONFIDENCE) ||
+                        isStatisticsEnabled(PITCH_YIN_FREQUENCY) || isStatisticsEnabled(PITCH_YIN_CONFIDENCE);
+    bool hpcpEnabled = isSubscribed(HPCP) || isSubscribed(HPCP_CREST) || isSubscribed(HPCP_ENTROPY) ||
+                       isStatisticsEnabled(HPCP_CREST) || isStatisticsEnabled(HPCP_ENTROPY);
+    for (auto unit : channelAnalyzerUnits){
+        unit->setPitchEnabled(pitchEnabled);
+        unit->setHpcpEnabled(hpcpEnabled);
+    }
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::isSilent() const {
+    if (channelAnalyzerUnits.empty()) return false;
+    for (auto unit : channelAnalyzerUnits){
+        if (unit->isGateOpen()) return false;
+    }
+    return true;
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::canAnalyze(int numChannels) const {
+    
+    if(numChannels != _channels){
+        ofxaa::log("ofxAudioAnalyzer: inBuffer channels number incorrect.");
+        return false;
     }
     
     if(channelAnalyzerUnits.size()!= _channels){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: wrong number of audioAnalyzerUnits");
-        return;
+        ofxaa::log("ofxAudioAnalyzer: wrong number of audioAnalyzerUnits");
+        return false;
+    }
+    
+    for (auto unit : channelAnalyzerUnits){
+        if (unit == nullptr){
+            ofxaa::log("ofxAudioAnalyzer: channelAnalyzer NULL pointer");
+            return false;
+        }
     }
+    return true;
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::analyze(const float* const* channelData, int numChannels, int numSamples, int stride){
+   
+    if (!canAnalyze(numChannels)) return;
+    
+    ofxaa::ScopedProfile profile(&profiler, ofxaa::Profiler::FrameNode);
+    
+    updateNormalizationModes();
+    updateSpectralEngines();
     
     for (int i=0; i<_channels; i++){
-        const float * channelPtr = buffer.getReadPointer(i);
-        vector<float> bufferCopy;
+        channelAnalyzerUnits[i]->analyze(channelData[i], numSamples, stride);
+    }
+    
+    updateSnapshot();
+    updateStatistics();
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::analyzeInterleaved(const float* data, int numChannels, int numSamples){
+    
+    if (!canAnalyze(numChannels)) return;
+    
+    ofxaa::ScopedProfile profile(&profiler, ofxaa::Profiler::FrameNode);
+    
+    updateNormalizationModes();
+    updateSpectralEngines();
+    
+    for (int i=0; i<_channels; i++){
+        channelAnalyzerUnits[i]->analyze(data + i, numSamples, numChannels);
+    }
+    
+    updateSnapshot();
+    updateStatistics();
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::feed(const float* const* channelData, int numChannels, int numSamples, int stride){
+    
+    if (!canAnalyze(numChannels)) return;
+    
+    for (int i=0; i<_channels; i++){
+        channelAnalyzerUnits[i]->feed(channelData[i], numSamples, stride);
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::subscribe(ofxAAValue valueType, float smooth){
+    if (valueType >= NONE) return;
+    if (!isComputed(valueType)){
+        ofxaa::log("ofxAudioAnalyzer: subscribe() to a value the backend doesn't compute, ignored");
+        return;
+    }
+    smoothingAmounts[valueType].store(smooth);
+    subscriptions[valueType].fetch_add(1);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::unsubscribe(ofxAAValue valueType){
+    if (valueType >= NONE || !isComputed(valueType)) return;
+    if (subscriptions[valueType].fetch_sub(1) <= 0){
+        ofxaa::log("ofxAudioAnalyzer: unsubscribe() without subscribe()");
+        subscriptions[valueType].store(0);
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::subscribe(ofxAABinsValue valueType){
+    if (valueType >= NONE_BINS) return;
+    if (!isComputed(valueType)){
+        ofxaa::log("ofxAudioAnalyzer: subscribe() to a value the backend doesn't compute, ignored");
+        return;
+    }
+    binsSubscriptions[valueType].fetch_add(1);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::unsubscribe(ofxAABinsValue valueType){
+    if (valueType >= NONE_BINS || !isComputed(valueType)) return;
+    if (binsSubscriptions[valueType].fetch_sub(1) <= 0){
+        ofxaa::log("ofxAudioAnalyzer: unsubscribe() without subscribe()");
+        binsSubscriptions[valueType].store(0);
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::setSmoothing(ofxAAValue valueType, float smooth){
+    if (valueType >= NONE) return;
+    smoothingAmounts[valueType].store(smooth);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::setActive(ofxAAValue valueType, bool state){
+    for (auto unit : channelAnalyzerUnits){
+        if (unit->getAlgorithmWithType(valueType) != NULL){
+            unit->setActive(valueType, state);
+        }
+    }
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::getIsActive(ofxAAValue valueType){
+    if (channelAnalyzerUnits.empty() || channelAnalyzerUnits[0]->getAlgorithmWithType(valueType) == NULL){
+        return false;
+    }
+    return channelAnalyzerUnits[0]->getIsActive(valueType);
+}
+//-------------------------------------------------------
+//MARK: Nodes
+static bool isPitchValue(ofxAAValue valueType){
+    return valueType == PITCH_YIN_FREQUENCY || valueType == PITCH_YIN_CONFIDENCE;
+}
+static bool isHpcpValue(ofxAAValue valueType){
+    return valueType == HPCP_CREST || valueType == HPCP_ENTROPY;
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::isNodeSubscribed(ofxAAValue valueType) const {
+    if (isPitchValue(valueType)){
+        return isSubscribed(PITCH_YIN_FREQUENCY) || isSubscribed(PITCH_YIN_CONFIDENCE);
+    }
+    if (isHpcpValue(valueType)){
+        return isSubscribed(HPCP_CREST) || isSubscribed(HPCP_ENTROPY) || isSubscribed(HPCP);
+    }
+    return isSubscribed(valueType);
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::getIsNodeActive(ofxAAValue valueType){
+    if (isPitchValue(valueType)){
+        return getIsActive(PITCH_YIN_FREQUENCY) || getIsActive(PITCH_YIN_CONFIDENCE);
+    }
+    if (isHpcpValue(valueType)){
+        return getIsActive(HPCP_CREST) || getIsActive(HPCP_ENTROPY) ||
+               (!channelAnalyzerUnits.empty() && channelAnalyzerUnits[0]->getIsActive(HPCP));
+    }
+    return getIsActive(valueType);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::setNodeActive(ofxAAValue valueType, bool state){
+    if (isPitchValue(valueType)){
+        setActive(PITCH_YIN_FREQUENCY, state);
+        setActive(PITCH_YIN_CONFIDENCE, state);
+    } else if (isHpcpValue(valueType)){
+        setActive(HPCP_CREST, state);
+        setActive(HPCP_ENTROPY, state);
+        for (auto unit : channelAnalyzerUnits){
+            unit->setActive(HPCP, state);
+        }
+    } else {
+        setActive(valueType, state);
+    }
+}
+//-------------------------------------------------------
+double ofxAudioAnalyzer::getNodeCostNs(ofxAAValue valueType){
+    if (channelAnalyzerUnits.empty() || channelAnalyzerUnits[0]->getAlgorithmWithType(valueType) == NULL){
+        return 0.0;
+    }
+    auto cost = [this](int node){ return profiler.getStats(node).meanNs; };
+    auto spectrumCost = cost(ofxaa::Windowing) + cost(ofxaa::Spectrum);
+    
+    if (isPitchValue(valueType)){
+        bool shared = isNodeSubscribed(HPCP_CREST) && getIsNodeActive(HPCP_CREST);
+        return cost(ofxaa::PitchYinFFT) + (shared ? 0.0 : spectrumCost);
+    }
+    if (isHpcpValue(valueType)){
+        bool shared = isNodeSubscribed(PITCH_YIN_FREQUENCY) && getIsNodeActive(PITCH_YIN_FREQUENCY);
+        return cost(ofxaa::SpectralPeaks) + cost(ofxaa::Hpcp) + cost(ofxaa::Crest) + cost(ofxaa::Entropy) +
+               (shared ? 0.0 : spectrumCost);
+    }
+    return cost(channelAnalyzerUnits[0]->getAlgorithmWithType(valueType)->getType());
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::updateSnapshot(){
+    auto size = channelAnalyzerUnits.size();
+    if (size == 0) return;
+    
+    snapshot.frameIndex++;
+    
+    for (int i=0; i<NONE; i++){
+        auto valueType = static_cast<ofxAAValue>(i);
+        bool wasSubscribed = snapshot.subscribed[i];
+        snapshot.subscribed[i] = subscriptions[i].load(std::memory_order_relaxed) > 0;
+        if (!snapshot.subscribed[i]) continue;
         
-        for(int i=0; i<buffer.getNumSamples();++i) {
-            bufferCopy.push_back(channelPtr[i]);
+        float raw = 0.0;
+        float normalized = 0.0;
+        for (auto unit : channelAnalyzerUnits){
+            raw += unit->getLinearValue(valueType);
+            normalized += unit->getNormalizedValue(valueType);
+        }
+        
+        auto& values = snapshot.values[i];
+        values.raw = raw / size;
+        values.normalized = normalized / size;
+        
+        float amount = wasSubscribed ? smoothingAmounts[i].load(std::memory_order_relaxed) : 0.0;
+        values.smoothed = values.smoothed * amount + (1 - amount) * values.raw;
+        values.smoothedNormalized = values.smoothedNormalized * amount + (1 - amount) * values.normalized;
+    }
+    
+    snapshotPublisher.publish(snapshot);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::publishSnapshot(const ofxaa::FrameSnapshot& values){
+    snapshot.frameIndex++;
+    snapshot.values = values.values;
+    snapshot.subscribed = values.subscribed;
+    snapshotPublisher.publish(snapshot);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::setNormalizationMode(ofxAAValue valueType, ofxaa::NormalizationMode mode, float seconds){
+    if (valueType >= NONE) return;
+    adaptationSeconds[valueType].store(mode == ofxaa::ADAPTIVE_NORMALIZATION ? std::max(seconds, 0.001f) : 0.0f);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::updateNormalizationModes(){
+    for (int i=0; i<NONE; i++){
+        float seconds = adaptationSeconds[i].load(std::memory_order_relaxed);
+        if (seconds == appliedAdaptationSeconds[i]) continue;
+        
+        auto valueType = static_cast<ofxAAValue>(i);
+        auto mode = seconds > 0 ? ofxaa::ADAPTIVE_NORMALIZATION : ofxaa::FIXED_NORMALIZATION;
+        int frames = (int)std::ceil(seconds * _samplerate / _buffersize);
+        for (auto unit : channelAnalyzerUnits){
+            if (unit->getAlgorithmWithType(valueType) != NULL){
+                unit->setNormalizationMode(valueType, mode, frames);
+            }
+        }
+        appliedAdaptationSeconds[i] = seconds;
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::enableStatistics(ofxAAValue valueType){
+    if (valueType >= NONE) return;
+    if (!isComputed(valueType)){
+        ofxaa::log("ofxAudioAnalyzer: enableStatistics() of a value the backend doesn't compute, ignored");
+        return;
+    }
+    statisticsRequests[valueType].fetch_add(1);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::disableStatistics(ofxAAValue valueType){
+    if (valueType >= NONE || !isComputed(valueType)) return;
+    if (statisticsRequests[valueType].fetch_sub(1) <= 0){
+        ofxaa::log("ofxAudioAnalyzer: disableStatistics() without enableStatistics()");
+        statisticsRequests[valueType].store(0);
+    }
+}
+//-------------------------------------------------------
+bool ofxAudioAnalyzer::getStatistics(ofxAAValue valueType, ofxaa::DescriptorStatistics& result) const {
+    if (valueType >= NONE) return false;
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    if (statistics[valueType] == nullptr) return false;
+    result = *statistics[valueType];
+    return true;
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::resetStatistics(ofxAAValue valueType){
+    if (valueType >= NONE) return;
+    statisticsResets[valueType].store(true);
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::createStatistics(){
+    ///new units start with statistics disabled, updateStatistics() enables them again.
+    ///The merged statistics outlive the units.
+    statisticsEnabled.fill(false);
+    if (channelAnalyzerUnits.empty()) return;
+    
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    for (int i=0; i<NONE; i++){
+        if (statistics[i] == nullptr && channelAnalyzerUnits[0]->getStatistics(static_cast<ofxAAValue>(i)) != NULL){
+            statistics[i].reset(new ofxaa::DescriptorStatistics());
+        }
+    }
+}
+//-------------------------------------------------------
+void ofxAudioAnalyzer::updateStatistics(){
+    bool hasWork = false;
+    for (int i=0; i<NONE; i++){
+        if (statistics[i] == nullptr) continue;
+        bool requested = statisticsRequests[i].load(std::memory_order_relaxed) > 0;
+        if (requested != statisticsEnabled[i]){
+            for (auto unit : channelAnalyzerUnits){
+                unit->setStatisticsEnabled(static_cast<ofxAAValue>(i), requested);
+            }
+            statisticsEnabled[i] = requested;
+        }
+        hasWork = hasWork || requested || statisticsResets[i].load(std::memory_order_relaxed);
+    }
+    if (!hasWork) return;
+    
+    std::unique_lock<std::mutex> lock(statisticsMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+    
+    for (int i=0; i<NONE; i++){
+        if (statistics[i] == nullptr) continue;
+        auto valueType = static_cast<ofxAAValue>(i);
+        bool reset = statisticsResets[i].exchange(false, std::memory_order_relaxed);
+        if (reset){
+            statistics[i]->clear();
         }
-        if(channelAnalyzerUnits[i]!=nullptr){
-            channelAnalyzerUnits[i]->analyze(bufferCopy);
-        }else{
-            juce::Logger::outputDebugString("ofxAudioAnalyzer: channelAnalyzer NULL pointer");
+        if (!statisticsEnabled[i] && !reset) continue;
+        for (auto unit : channelAnalyzerUnits){
+            auto unitStatistics = unit->getStatistics(valueType);
+            if (!reset){
+                statistics[i]->merge(*unitStatistics);
+            }
+            unitStatistics->clear();
         }
     }
 }
@@ -110,7 +499,7 @@ void ofxAudioAnalyzer::exit(){
 //-------------------------------------------------------
 float ofxAudioAnalyzer::getValue(ofxAAValue valueType, int channel, float smooth, bool normalized) const {
     if (channel >= _channels){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for getting value is incorrect.");
+        ofxaa::log("ofxAudioAnalyzer: channel for getting value is incorrect.");
         return 0.0;
     }
     return channelAnalyzerUnits[channel]->getValue(valueType, smooth, normalized);
@@ -119,7 +508,7 @@ float ofxAudioAnalyzer::getValue(ofxAAValue valueType, int channel, float smooth
 float ofxAudioAnalyzer:: getAverageValue(ofxAAValue valueType, float smooth, bool normalized) const {
     auto size = channelAnalyzerUnits.size();
     if (size <= 0){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for getting value is incorrect.");
+        ofxaa::log("ofxAudioAnalyzer: channel for getting value is incorrect.");
         return 0.0;
     }
     float value = 0.0;
@@ -133,7 +522,7 @@ float ofxAudioAnalyzer:: getAverageValue(ofxAAValue valueType, float smooth, boo
 vector<float>& ofxAudioAnalyzer::getValues(ofxAABinsValue valueType, int channel, float smooth, bool normalized){
     
     if (channel >= _channels){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for getting value is incorrect.");
+        ofxaa::log("ofxAudioAnalyzer: channel for getting value is incorrect.");
         static vector<float>r (1, 0.0);
         return r;
     }
@@ -145,7 +534,7 @@ vector<float>& ofxAudioAnalyzer::getValues(ofxAABinsValue valueType, int channel
 //bool ofxAudioAnalyzer::getOnsetValue(int channel) const {
 //    
 //    if (channel >= _channels){
-//        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for getting value is incorrect.");
+//        ofxaa::log("ofxAudioAnalyzer: channel for getting value is incorrect.");
 //        return false;
 //    }
 //    return channelAnalyzerUnits[channel]->getValue(ONSETS, 0.0, false);
@@ -155,7 +544,7 @@ vector<float>& ofxAudioAnalyzer::getValues(ofxAABinsValue valueType, int channel
 //void ofxAudioAnalyzer::resetOnsets(int channel){
 //    
 //    if (channel >= _channels){
-//        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for getting value is incorrect.");
+//        ofxaa::log("ofxAudioAnalyzer: channel for getting value is incorrect.");
 //        return;
 //    }
 //    
@@ -165,7 +554,7 @@ vector<float>& ofxAudioAnalyzer::getValues(ofxAABinsValue valueType, int channel
 void ofxAudioAnalyzer::setMaxEstimatedValue(int channel, ofxAAValue valueType, float value){
     
     if (channel >= _channels){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for setting max estimated value is incorrect.");
+        ofxaa::log("ofxAudioAnalyzer: channel for setting max estimated value is incorrect.");
         return;
     }
     
@@ -176,7 +565,7 @@ void ofxAudioAnalyzer::setMaxEstimatedValue(int channel, ofxAAValue valueType, f
 void ofxAudioAnalyzer::setMaxEstimatedValue(int channel, ofxAABinsValue valueType, float value){
     
     if (channel >= _channels){
-        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for setting max estimated value is incorrect.");
+        ofxaa::log("ofxAudioAnalyzer: channel for setting max estimated value is incorrect.");
         return;
     }
     
@@ -186,7 +575,7 @@ void ofxAudioAnalyzer::setMaxEstimatedValue(int channel, ofxAABinsValue valueTyp
 //void ofxAudioAnalyzer::setOnsetsParameters(int channel, float alpha, float silenceTresh, float timeTresh, bool useTimeTresh){
 //    
 //    if (channel >= _channels){
-//        juce::Logger::outputDebugString("ofxAudioAnalyzer: channel for getting value is incorrect.");
+//        ofxaa::log("ofxAudioAnalyzer: channel for getting value is incorrect.");
 //        return;
 //    }
 //    auto onsets =  channelAnalyzerUnits[channel]->getOnsetsPtr();
@@ -26,22 +26,125 @@
 
 //
 #include "ofxAudioAnalyzerUnit.h"
-#include <JuceHeader.h>
+#include "ofxAASnapshot.h"
+#include "ofxAAProfiler.h"
+#include <map>
+#include <mutex>
 
 class ofxAudioAnalyzer{
  
  public:
     
+    ~ofxAudioAnalyzer();
+    
     void setup(int sampleRate, int bufferSize, int channels);
     void reset(int sampleRate, int bufferSize, int channels);
-    void analyze(const juce::AudioBuffer<float>& buffer);
+    ///Backend of the networks created by the next setup() or reset(). See ofxaa::StreamingNetwork.
+    ///Drops the subscriptions and statistics of values the backend doesn't compute.
+    ///\param frameSize, hopSize: framing of the STREAMING_BACKEND, 0 for the buffer size
+    void setBackend(ofxaa::NetworkBackend backend, int frameSize=0, int hopSize=0);
+    ofxaa::NetworkBackend getBackend() const { return _backend; }
+    ///False for the values the backend doesn't compute (see ofxaa::StreamingNetwork::computesValue()),
+    ///subscribe() rejects them.
+    bool isComputed(ofxAAValue valueType) const;
+    bool isComputed(ofxAABinsValue valueType) const;
+    ///Silence gate of every channel (see ofxaa::SilenceGateSettings), enabled by default.
+    ///Kept through reset(). Call before setup() or from the thread that runs analyze().
+    void setSilenceGate(const ofxaa::SilenceGateSettings& settings);
+    const ofxaa::SilenceGateSettings& getSilenceGate() const { return _silenceGate; }
+    ///True while the gate of every channel is closed.
+    bool isSilent() const;
+    ///Voicing and confidence gating of the pitch engine, see ofxaa::PitchSettings.
+    ///The engine only runs while PITCH_YIN_FREQUENCY or PITCH_YIN_CONFIDENCE is subscribed
+    ///or has statistics enabled. Kept through reset(). Call before setup() or from the thread that runs analyze().
+    void setPitchSettings(const ofxaa::PitchSettings& settings);
+    const ofxaa::PitchSettings& getPitchSettings() const { return _pitchSettings; }
+    ///Size (12, 24, 36 bins) and harmonics of the HPCP, see ofxaa::HpcpMapper. The HPCP engine
+    ///only runs while HPCP is subscribed, or HPCP_CREST or HPCP_ENTROPY is subscribed or has
+    ///statistics enabled. Kept through reset(). Allocates: call before setup() or from the thread that runs analyze().
+    void setHpcpSettings(const ofxaa::HpcpSettings& settings);
+    const ofxaa::HpcpSettings& getHpcpSettings() const { return _hpcpSettings; }
+    ///Analyzes one block of non-interleaved audio.
+    ///\param channelData: one pointer per channel, numChannels must match the channels set in setup()
+    ///\param stride: distance between consecutive samples of a channel, 1 for contiguous buffers
+    void analyze(const float* const* channelData, int numChannels, int numSamples, int stride=1);
+    ///Analyzes one block of interleaved audio (frame by frame, numChannels samples each).
+    void analyzeInterleaved(const float* data, int numChannels, int numSamples);
+    ///Takes a block that isn't analyzed (skipped by the governor) like analyze(), so the pitch and
+    ///HPCP frames, which span several blocks, stay continuous. Values and statistics don't change.
+    void feed(const float* const* channelData, int numChannels, int numSamples, int stride=1);
+    ///Shuts Essentia down, for every analyzer in the process. The units are deleted by the destructor.
     void exit();
     
     int getSampleRate() const {return _samplerate;}
     int getBufferSize() const {return _buffersize;}
     int getChannelsNum() const {return _channels;}
     
+    ///Adds a consumer of the value to the per-frame snapshot. Subscriptions are counted,
+    ///every subscribe() needs its unsubscribe(). Can be called from any thread.
+    ///Values the backend doesn't compute (isComputed()) are logged and ignored.
+    ///\param smooth: smoothing amount applied once per frame. Shared by all subscribers of the value.
+    void subscribe(ofxAAValue valueType, float smooth=0.0);
+    void unsubscribe(ofxAAValue valueType);
+    void setSmoothing(ofxAAValue valueType, float smooth);
+    bool isSubscribed(ofxAAValue valueType) const { return valueType < NONE && subscriptions[valueType].load() > 0; }
+    ///Vector values aren't in the snapshot, read them with getValues() from the thread that runs
+    ///analyze(). Subscribing keeps the engines that only run on demand (HPCP) computing them.
+    ///Counted like subscribe(ofxAAValue). Can be called from any thread.
+    void subscribe(ofxAABinsValue valueType);
+    void unsubscribe(ofxAABinsValue valueType);
+    bool isSubscribed(ofxAABinsValue valueType) const { return valueType < NONE_BINS && binsSubscriptions[valueType].load() > 0; }
+    
+    ///Activates or deactivates the algorithm of the value in every channel. Inactive algorithms
+    ///aren't computed and their values are 0. Call from the thread that runs analyze().
+    void setActive(ofxAAValue valueType, bool state);
+    ///False if the value isn't in the network.
+    bool getIsActive(ofxAAValue valueType);
+    
+    ///Nodes, as degraded by the governor: the pitch and HPCP values stand for their whole engine
+    ///(the HPCP bins included), any other value for its own algorithm. Deactivating a single output
+    ///of an engine saves nothing while another one keeps it running.
+    ///Call from the thread that runs analyze().
+    bool isNodeSubscribed(ofxAAValue valueType) const;
+    bool getIsNodeActive(ofxAAValue valueType);
+    void setNodeActive(ofxAAValue valueType, bool state);
+    ///Mean compute time of the node in one channel, from the profiler. An engine counts every
+    ///algorithm it runs, the windowing and spectrum only if no other running engine shares them.
+    double getNodeCostNs(ofxAAValue valueType);
+    
+    ///How the normalized values of the value are computed, in every channel: FIXED_NORMALIZATION
+    ///(the default) maps the min and max estimated values to 0..1, ADAPTIVE_NORMALIZATION maps
+    ///the 5th and 95th percentiles of roughly the last adaptationSeconds to 0..1.
+    ///Kept through reset(). Can be called from any thread, applies from the next analyzed block.
+    void setNormalizationMode(ofxAAValue valueType, ofxaa::NormalizationMode mode,
+                              float adaptationSeconds=ADAPTIVE_NORMALIZATION_SECONDS);
+    
+    ///Running statistics (mean, variance, min/max, quantiles) of the raw value of every analyzed
+    ///frame the silence gate lets through, merged over all channels. Counted like subscribe(): every enableStatistics() needs
+    ///its disableStatistics(). Disabling keeps what was gathered. Can be called from any thread.
+    void enableStatistics(ofxAAValue valueType);
+    void disableStatistics(ofxAAValue valueType);
+    bool isStatisticsEnabled(ofxAAValue valueType) const { return valueType < NONE && statisticsRequests[valueType].load() > 0; }
+    ///Copies the statistics gathered so far. False for values not in the network.
+    ///Can be called from any thread, never blocks the analysis.
+    bool getStatistics(ofxAAValue valueType, ofxaa::DescriptorStatistics& result) const;
+    ///Starts the statistics of the value over, from the next analyzed block. Can be called from any thread.
+    void resetStatistics(ofxAAValue valueType);
+    
+    ///Compute time of every algorithm and of the whole analyze() call. Disabled by default.
+    ofxaa::Profiler& getProfiler() { return profiler; }
+    const ofxaa::Profiler& getProfiler() const { return profiler; }
+    
+    ///Snapshot of the last analyzed frame. Only for the thread calling analyze().
+    const ofxaa::FrameSnapshot& getSnapshot() const { return snapshot; }
+    ///Copy of the last published snapshot. Lock-free, for any other thread.
+    ofxaa::FrameSnapshot readSnapshot() const { return snapshotPublisher.read(); }
+    ///Publishes values computed elsewhere (e.g. a replayed recording) as the next frame,
+    ///instead of analyzing a block. Call from the thread that runs analyze().
+    void publishSnapshot(const ofxaa::FrameSnapshot& values);
+    
     ///Gets value of single output  Algorithms.
+    ///Every call advances the smoothing of the value, prefer getSnapshot() for repeated reads.
     ///\param algorithm
     ///\param channel: starting from 0 (for stereo setup, 0 and 1)
     ///\param smooth: smoothing amount. 0.0=non smoothing, 1.0=fixed value
@@ -79,15 +182,51 @@ class ofxAudioAnalyzer{
 
  private:
     
+    ///Channels and units match, logs why not. Shared by analyze(), analyzeInterleaved() and feed().
+    bool canAnalyze(int numChannels) const;
     void loadStoredMaxEstimatedValues();
+    void updateSnapshot();
+    void createStatistics();
+    void updateStatistics();
+    void updateNormalizationModes();
+    void updateSpectralEngines();
+    
+    int _samplerate = 0;
+    int _buffersize = 0;
+    int _channels = 0;
     
-    int _samplerate;
-    int _buffersize;
-    int _channels;
+    ofxaa::NetworkBackend _backend = ofxaa::STANDARD_BACKEND;
+    int _streamingFrameSize = 0;
+    int _streamingHopSize = 0;
+    ofxaa::SilenceGateSettings _silenceGate;
+    ofxaa::PitchSettings _pitchSettings;
+    ofxaa::HpcpSettings _hpcpSettings;
     
     map<ofxAAValue, float> storedMaxEstimatedValues;
     
     vector<ofxAudioAnalyzerUnit*> channelAnalyzerUnits;
     
+    std::array<std::atomic<int>, NONE> subscriptions {};
+    std::array<std::atomic<float>, NONE> smoothingAmounts {};
+    std::array<std::atomic<int>, NONE_BINS> binsSubscriptions {};
+    
+    ///Adaptation time per value, 0 for FIXED_NORMALIZATION
+    std::array<std::atomic<float>, NONE> adaptationSeconds {};
+    ///What the units were last told, only for the analysis thread
+    std::array<float, NONE> appliedAdaptationSeconds {};
+    
+    std::array<std::atomic<int>, NONE> statisticsRequests {};
+    std::array<std::atomic<bool>, NONE> statisticsResets {};
+    ///What the units were last told, only for the analysis thread
+    std::array<bool, NONE> statisticsEnabled {};
+    ///Merged statistics of all channels, guarded by statisticsMutex. The analysis thread only
+    ///try-locks it: if a reader holds it, the units keep the frames until the next block.
+    std::array<std::unique_ptr<ofxaa::DescriptorStatistics>, NONE> statistics;
+    mutable std::mutex statisticsMutex;
+    
+    ofxaa::FrameSnapshot snapshot;
+    ofxaa::SnapshotPublisher snapshotPublisher;
+    
+    ofxaa::Profiler profiler;
 };
 
@@ -24,37 +24,56 @@
 
 #include "ofxAudioAnalyzerUnit.h"
 #include "ofxAAConfigurations.h"
+#include "ofxAAStreamingNetwork.h"
 
 #pragma mark - Main funcs
 #define ACCUMULATED_BUFFER_SIZE 1024
 
-ofxAudioAnalyzerUnit::ofxAudioAnalyzerUnit(int sampleRate, int bufferSize) {
+ofxAudioAnalyzerUnit::ofxAudioAnalyzerUnit(int sampleRate, int bufferSize, ofxaa::NetworkBackend backend,
+                                           int streamingFrameSize, int streamingHopSize) {
     samplerate = sampleRate;
     framesize = ACCUMULATED_BUFFER_SIZE;
     
     audioBuffer.resize(bufferSize, 0.0);
     accumulatedAudioBuffer.resize(ACCUMULATED_BUFFER_SIZE, 0.0);
     
-    network = new ofxaa::Network(samplerate, framesize);
+    if (backend == ofxaa::STREAMING_BACKEND){
+        network = new ofxaa::StreamingNetwork(samplerate, bufferSize, streamingFrameSize, streamingHopSize);
+    } else {
+        network = new ofxaa::Network(samplerate, framesize);
+    }
+    _profiler = NULL;
 }
 //--------------------------------------------------------------
-void ofxAudioAnalyzerUnit::analyze(const vector<float> & inBuffer){
+void ofxAudioAnalyzerUnit::analyze(const float* samples, int numSamples, int stride){
     
 //    if(inBuffer.size() != framesize){
 //        cout<<"ofxAudioAnalyzerUnit: buffer requested to analyze size(" <<inBuffer.size()<<")doesnt match the buffer size already set: "<<framesize<< endl;
 //    }
     
+    int size = fillAudioBuffer(samples, numSamples, stride);
+    network->computeAlgorithms(audioBuffer, size);
+}
+//--------------------------------------------------------------
+void ofxAudioAnalyzerUnit::feed(const float* samples, int numSamples, int stride){
+    int size = fillAudioBuffer(samples, numSamples, stride);
+    network->feedAlgorithms(audioBuffer, size);
+}
+//--------------------------------------------------------------
+int ofxAudioAnalyzerUnit::fillAudioBuffer(const float* samples, int numSamples, int stride){
     //Cast of incoming audio buffer to Real
-    for (int i=0; i<inBuffer.size();i++){
-        audioBuffer[i] = (Real) inBuffer[i];
+    ofxaa::ScopedProfile profile(_profiler, ofxaa::Profiler::FramingNode);
+    int size = std::max(0, std::min(numSamples, (int)audioBuffer.size()));
+    for (int i=0; i<size;i++){
+        audioBuffer[i] = (Real) samples[i * stride];
     }
-    
-    network->computeAlgorithms(audioBuffer);
+    return size;
 }
 
 //--------------------------------------------------------------
 void ofxAudioAnalyzerUnit::exit(){
     delete network;
+    network = NULL;
 }
 
 //--------------------------------------------------------------
@@ -32,20 +32,31 @@ class ofxAudioAnalyzerUnit
 
 public:
     
-    ofxAudioAnalyzerUnit(int sampleRate, int bufferSize);
+    ///\param streamingFrameSize, streamingHopSize: framing of the STREAMING_BACKEND, 0 for bufferSize
+    ofxAudioAnalyzerUnit(int sampleRate, int bufferSize, ofxaa::NetworkBackend backend = ofxaa::STANDARD_BACKEND,
+                         int streamingFrameSize = 0, int streamingHopSize = 0);
     
     ~ofxAudioAnalyzerUnit(){
         exit();
     }
     
-    void analyze(const vector<float> &  inBuffer);
+    ///Copies numSamples samples, stride apart, into the analysis buffer. Extra samples beyond
+    ///the buffer size given in the constructor are ignored.
+    void analyze(const float* samples, int numSamples, int stride=1);
+    void analyze(const vector<float> &  inBuffer){ analyze(inBuffer.data(), (int)inBuffer.size()); }
+    ///Copies the samples like analyze() but only keeps the frames that span several blocks going.
+    void feed(const float* samples, int numSamples, int stride=1);
     void exit();
     
+    void setProfiler(ofxaa::Profiler* profiler){ _profiler = profiler; network->setProfiler(profiler); }
+    
     int getSampleRate() {return samplerate;}
     int getBufferSize() {return framesize;}
     
     float getValue(ofxAAValue value, float smooth, bool normalized);
     float getValue(ofxAAValue value){ return getValue(value, 0.0, false); }
+    float getLinearValue(ofxAAValue value){ return network->getLinearValue(value); }
+    float getNormalizedValue(ofxAAValue value){ return network->getNormalizedValue(value); }
     vector<float>& getValues(ofxAABinsValue value, float smooth , bool normalized);
     vector<float>& getValues(ofxAABinsValue value){ return getValues(value, 0.0, false); }
     
@@ -55,6 +66,20 @@ public:
     bool getIsActive(ofxAAValue valueType);
     bool getIsActive(ofxAABinsValue valueType);
     
+    void setSilenceGate(const ofxaa::SilenceGateSettings& settings){ network->setSilenceGate(settings); }
+    bool isGateOpen() const { return network->isGateOpen(); }
+    
+    void setPitchEnabled(bool state){ network->setPitchEnabled(state); }
+    void setPitchSettings(const ofxaa::PitchSettings& settings){ network->setPitchSettings(settings); }
+    void setHpcpEnabled(bool state){ network->setHpcpEnabled(state); }
+    void setHpcpSettings(const ofxaa::HpcpSettings& settings){ network->setHpcpSettings(settings); }
+    
+    void setNormalizationMode(ofxAAValue valueType, ofxaa::NormalizationMode mode, int adaptationFrames){ network->setNormalizationMode(valueType, mode, adaptationFrames); }
+    
+    void setStatisticsEnabled(ofxAAValue valueType, bool state){ network->setStatisticsEnabled(valueType, state); }
+    ///Statistics of the frames analyzed by this unit. NULL for values not in the network.
+    ofxaa::DescriptorStatistics* getStatistics(ofxAAValue valueType){ return network->getStatistics(valueType); }
+    
     float getMaxEstimatedValue(ofxAAValue valueType);
     float getMaxEstimatedValue(ofxAABinsValue valueType);
     
@@ -69,7 +94,11 @@ public:
     ofxAAOneVectorOutputAlgorithm* getAlgorithmWithType(ofxAABinsValue valueType) { return network->getAlgorithmWithType(valueType); };
     
 private:
+    ///Returns the number of samples copied.
+    int fillAudioBuffer(const float* samples, int numSamples, int stride);
+    
     ofxaa::Network* network; 
+    ofxaa::Profiler* _profiler;
     
     vector<Real> audioBuffer;
     vector<Real> accumulatedAudioBuffer;
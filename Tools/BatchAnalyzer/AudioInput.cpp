@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "AudioInput.h"
+#include "MappedPcmInput.h"
+
+#include "algorithmfactory.h"
+
+#include <algorithm>
+
+using namespace essentia;
+using namespace standard;
+
+namespace ofxaa { namespace batch {
+
+    class DecodedAudioInput : public AudioInput {
+    public:
+        DecodedAudioInput(int sampleRate, int numChannels, std::shared_ptr<const std::vector<float>> samples)
+            : _samplerate(sampleRate), _channels(numChannels), _samples(std::move(samples)) {}
+
+        int getSampleRate() const override { return _samplerate; }
+        int getNumChannels() const override { return _channels; }
+        int64_t getNumFrames() const override { return (int64_t)_samples->size() / _channels; }
+
+        int read(float* interleaved, int maxFrames) override {
+            auto frames = (int)std::min<int64_t>(maxFrames, getNumFrames() - position);
+            if (frames <= 0) return 0;
+            std::copy_n(_samples->data() + position * _channels, frames * _channels, interleaved);
+            position += frames;
+            return frames;
+        }
+
+        void seek(int64_t frame) override {
+            position = std::max<int64_t>(0, std::min(frame, getNumFrames()));
+        }
+
+        std::unique_ptr<AudioInput> clone() const override {
+            return std::unique_ptr<AudioInput>(new DecodedAudioInput(_samplerate, _channels, _samples));
+        }
+
+    private:
+        int _samplerate;
+        int _channels;
+        std::shared_ptr<const std::vector<float>> _samples;
+        int64_t position = 0;
+    };
+
+    //----------------------------------------------
+    std::unique_ptr<AudioInput> openAudioInput(const std::string& path, std::string& error){
+        std::string mappedError;
+        if (auto mapped = MappedPcmInput::open(path, mappedError)){
+            return mapped;
+        }
+
+        std::vector<StereoSample> audio;
+        Real sampleRate = 0;
+        int numberChannels = 0;
+        std::string md5, codec;
+        int bitRate = 0;
+
+        try {
+            std::unique_ptr<Algorithm> loader(AlgorithmFactory::create("AudioLoader", "filename", path));
+            loader->output("audio").set(audio);
+            loader->output("sampleRate").set(sampleRate);
+            loader->output("numberChannels").set(numberChannels);
+            loader->output("md5").set(md5);
+            loader->output("bit_rate").set(bitRate);
+            loader->output("codec").set(codec);
+            loader->compute();
+        } catch (const std::exception& e){
+            error = e.what();
+            return nullptr;
+        }
+
+        ///AudioLoader always returns stereo samples, mono files have the same value on both sides
+        int channels = numberChannels == 1 ? 1 : 2;
+        auto samples = std::make_shared<std::vector<float>>();
+        samples->reserve(audio.size() * channels);
+        for (auto& sample : audio){
+            samples->push_back(sample.left());
+            if (channels == 2) samples->push_back(sample.right());
+        }
+        return std::unique_ptr<AudioInput>(new DecodedAudioInput((int)sampleRate, channels, std::move(samples)));
+    }
+}}
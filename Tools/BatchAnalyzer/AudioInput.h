@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ofxaa { namespace batch {
+
+    ///Source of interleaved float samples for the batch analyzer.
+    class AudioInput {
+    public:
+        virtual ~AudioInput() = default;
+
+        virtual int getSampleRate() const = 0;
+        virtual int getNumChannels() const = 0;
+        virtual int64_t getNumFrames() const = 0;
+
+        ///Reads up to maxFrames frames (numChannels samples each) from the current position.
+        ///Returns the number of frames read, 0 at the end of the file.
+        virtual int read(float* interleaved, int maxFrames) = 0;
+
+        ///Moves the read position to frame, clamped to the end of the file.
+        virtual void seek(int64_t frame) = 0;
+
+        ///Independent reader of the same audio, positioned at the start. Cheap: the data is shared,
+        ///so several threads can read different parts of one file. nullptr if it fails.
+        virtual std::unique_ptr<AudioInput> clone() const = 0;
+    };
+
+    ///Uncompressed WAV, RF64 and AIFF files are streamed from a memory mapping (see MappedPcmInput),
+    ///anything else is decoded as a whole with Essentia's AudioLoader (any format its ffmpeg build supports).
+    ///Returns nullptr and sets error if the file can't be opened.
+    std::unique_ptr<AudioInput> openAudioInput(const std::string& path, std::string& error);
+}}
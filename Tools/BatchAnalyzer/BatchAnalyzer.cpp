@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "BatchAnalyzer.h"
+#include "ValueNames.h"
+#include "ofxAudioAnalyzer.h"
+#include "ofxAAStreamingNetwork.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace ofxaa { namespace batch {
+
+    //MARK: - Setup
+
+    static bool checkFormat(const AudioInput& input, const AnalysisSettings& settings, std::string& error){
+        if (input.getNumChannels() <= 0 || input.getSampleRate() <= 0){
+            error = "invalid audio format";
+            return false;
+        }
+        if (settings.blockSize <= 0){
+            error = "invalid block size";
+            return false;
+        }
+        if (settings.backend == ofxaa::STREAMING_BACKEND){
+            for (auto& meter : settings.meters){
+                if (meter.value != NONE && !ofxaa::StreamingNetwork::computesValue(meter.value)){
+                    error = "the streaming backend doesn't compute " + utils::valueTypeToString(meter.value);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    //----------------------------------------------
+    ///Distinct subscribed values, in meter order
+    static std::vector<ofxAAValue> selectedValues(const AnalysisSettings& settings){
+        std::vector<ofxAAValue> values;
+        for (auto& meter : settings.meters){
+            if (meter.value != NONE && std::find(values.begin(), values.end(), meter.value) == values.end()){
+                values.push_back(meter.value);
+            }
+        }
+        return values;
+    }
+    //----------------------------------------------
+    ///Same calls MeterUnit makes when its parameters are restored
+    static void setupAnalyzer(ofxAudioAnalyzer& analyzer, const AudioInput& input, const AnalysisSettings& settings){
+        int channels = input.getNumChannels();
+        analyzer.setBackend(settings.backend);
+        analyzer.setup(input.getSampleRate(), settings.blockSize, channels);
+        for (auto& meter : settings.meters){
+            if (meter.value == NONE) continue;
+            analyzer.subscribe(meter.value, meter.smoothing);
+            analyzer.setNormalizationMode(meter.value, meter.adaptationSeconds > 0 ? ofxaa::ADAPTIVE_NORMALIZATION : ofxaa::FIXED_NORMALIZATION,
+                                          meter.adaptationSeconds);
+            if (meter.maxEstimated != 1.0){
+                for (int ch=0; ch<channels; ch++){
+                    analyzer.setMaxEstimatedValue(ch, meter.value, meter.maxEstimated);
+                }
+            }
+        }
+    }
+    //----------------------------------------------
+    static void setupColumns(FeatureStream& features, const AudioInput& input, const AnalysisSettings& settings,
+                             const std::vector<ofxAAValue>& values){
+        features.sampleRate = input.getSampleRate();
+        features.blockSize = settings.blockSize;
+        features.columns.clear();
+        for (auto value : values){
+            ofxaa::addDescriptorColumns(features.columns, value, utils::valueTypeToString(value));
+        }
+        features.values.clear();
+    }
+    //----------------------------------------------
+    static void writeRow(const ofxAudioAnalyzer& analyzer, const std::vector<ofxAAValue>& values, float* row){
+        auto& snapshot = analyzer.getSnapshot();
+        for (auto value : values){
+            *row++ = snapshot.get(value).smoothedNormalized;
+            *row++ = snapshot.get(value).smoothed;
+        }
+    }
+
+    //MARK: - Analysis
+
+    bool analyze(AudioInput& input, const AnalysisSettings& settings, FeatureStream& features, std::string& error){
+        if (!checkFormat(input, settings, error)) return false;
+        auto values = selectedValues(settings);
+        if (values.empty()){
+            error = "no descriptors selected";
+            return false;
+        }
+
+        ofxAudioAnalyzer analyzer;
+        setupAnalyzer(analyzer, input, settings);
+        setupColumns(features, input, settings, values);
+        auto numColumns = features.columns.size();
+        auto expectedFrames = input.getNumFrames() / settings.blockSize + 1;
+        features.values.reserve(expectedFrames * numColumns);
+
+        int channels = input.getNumChannels();
+        std::vector<float> block(settings.blockSize * channels);
+        int frames;
+        while ((frames = input.read(block.data(), settings.blockSize)) > 0){
+            analyzer.analyzeInterleaved(block.data(), channels, frames);
+            features.values.resize(features.values.size() + numColumns);
+            writeRow(analyzer, values, features.values.data() + features.values.size() - numColumns);
+        }
+        return true;
+    }
+    //----------------------------------------------
+    bool analyzeChunked(AudioInput& input, const AnalysisSettings& settings, const ChunkSettings& chunks,
+                        FeatureStream& features, std::string& error){
+        if (!checkFormat(input, settings, error)) return false;
+        auto values = selectedValues(settings);
+        if (values.empty()){
+            error = "no descriptors selected";
+            return false;
+        }
+
+        ///adaptive normalization weighs values by exp(-age / adaptationSeconds)
+        double warmupSeconds = chunks.warmupSeconds;
+        for (auto& meter : settings.meters){
+            if (meter.value == NONE) continue;
+            warmupSeconds = std::max(warmupSeconds, ADAPTIVE_WARMUP_TIME_CONSTANTS * meter.adaptationSeconds);
+        }
+        ///each chunk would analyze more audio before it than in it
+        if (warmupSeconds > chunks.chunkSeconds){
+            return analyze(input, settings, features, error);
+        }
+
+        setupColumns(features, input, settings, values);
+        auto numColumns = features.columns.size();
+        int blockSize = settings.blockSize;
+        double blocksPerSecond = double(input.getSampleRate()) / blockSize;
+
+        ///Analysis frames, the last one can be a partial block like in analyze()
+        int64_t numFrames = input.getNumFrames();
+        int64_t totalFrames = (numFrames + blockSize - 1) / blockSize;
+        int64_t chunkFrames = std::max<int64_t>(1, std::llround(chunks.chunkSeconds * blocksPerSecond));
+        int64_t warmupFrames = std::max<int64_t>(0, std::llround(warmupSeconds * blocksPerSecond));
+        int64_t numChunks = (totalFrames + chunkFrames - 1) / chunkFrames;
+
+        ///Every chunk writes its own rows, no stitching needed afterwards
+        features.values.assign(totalFrames * numColumns, 0.0);
+
+        std::atomic<int64_t> nextChunk { 0 };
+        std::mutex errorMutex;
+        bool failed = false;
+
+        auto worker = [&]{
+            auto reader = input.clone();
+            if (reader == nullptr){
+                std::lock_guard<std::mutex> lock(errorMutex);
+                failed = true;
+                error = "can't open another reader of the input";
+                return;
+            }
+            int channels = reader->getNumChannels();
+            std::vector<float> block(blockSize * channels);
+
+            for (int64_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++){
+                int64_t first = chunk * chunkFrames;
+                int64_t last = std::min(totalFrames, first + chunkFrames);
+                int64_t warmupStart = std::max<int64_t>(0, first - warmupFrames);
+
+                ofxAudioAnalyzer analyzer;
+                setupAnalyzer(analyzer, *reader, settings);
+                reader->seek(warmupStart * blockSize);
+
+                for (int64_t frame = warmupStart; frame < last; frame++){
+                    ///only the last block of the input is partial
+                    int expected = (int)std::min<int64_t>(blockSize, numFrames - frame * blockSize);
+                    int frames = 0;
+                    while (frames < expected){
+                        int read = reader->read(block.data() + frames * channels, blockSize - frames);
+                        if (read <= 0) break;
+                        frames += read;
+                    }
+                    if (frames < expected){
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        failed = true;
+                        error = "can't read the input at sample " + std::to_string(frame * blockSize);
+                        return;
+                    }
+                    analyzer.analyzeInterleaved(block.data(), channels, frames);
+                    if (frame >= first){
+                        writeRow(analyzer, values, features.values.data() + frame * numColumns);
+                    }
+                }
+            }
+        };
+
+        int jobs = (int)std::max<int64_t>(1, std::min<int64_t>(chunks.jobs, numChunks));
+        std::vector<std::thread> threads;
+        for (int j=1; j<jobs; j++){
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads){
+            thread.join();
+        }
+        return !failed;
+    }
+    //----------------------------------------------
+    float maxDifference(const FeatureStream& a, const FeatureStream& b, std::string& column){
+        column.clear();
+        if (a.columns != b.columns || a.values.size() != b.values.size()){
+            return std::numeric_limits<float>::infinity();
+        }
+        float result = 0.0;
+        auto numColumns = a.columns.size();
+        for (size_t i=0; i<a.values.size(); i++){
+            float difference = std::fabs(a.values[i] - b.values[i]);
+            if (difference > result){
+                result = difference;
+                column = a.columns[i % numColumns].name;
+            }
+        }
+        return result;
+    }
+    //----------------------------------------------
+    void writeCsv(const FeatureStream& features, std::ostream& stream){
+        stream << "frame,time";
+        for (auto& column : features.columns){
+            stream << "," << column.name;
+        }
+        stream << "\n";
+
+        auto numColumns = features.columns.size();
+        auto numFrames = features.getNumFrames();
+        stream.precision(7);
+        for (int64_t frame=0; frame<numFrames; frame++){
+            stream << frame << "," << double(frame) * features.blockSize / features.sampleRate;
+            for (size_t c=0; c<numColumns; c++){
+                stream << "," << features.values[frame * numColumns + c];
+            }
+            stream << "\n";
+        }
+    }
+    //----------------------------------------------
+    bool writeFeatureFile(const FeatureStream& features, const std::string& path, std::string& error){
+        ofxaa::FeatureFileWriter writer;
+        if (!writer.open(path, features.sampleRate, features.blockSize, features.columns, false, error)){
+            return false;
+        }
+        auto numColumns = features.columns.size();
+        for (int64_t frame=0; frame<features.getNumFrames(); frame++){
+            writer.addRow(features.values.data() + frame * numColumns);
+        }
+        if (!writer.close()){
+            error = "can't write " + path;
+            return false;
+        }
+        return true;
+    }
+}}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "AudioInput.h"
+#include "PluginState.h"
+#include "ofxAAFeatureFile.h"
+#include "ofxAANetwork.h"
+
+#include <ostream>
+
+///Warm-up of a chunk with adaptive normalization, in time constants of the meter:
+///older values keep less than exp(-8) of their weight.
+#define ADAPTIVE_WARMUP_TIME_CONSTANTS 8.0
+
+namespace ofxaa { namespace batch {
+
+    struct AnalysisSettings {
+        std::vector<MeterSettings> meters;
+        ///Samples per analysis frame, the host block size of the plug-in
+        int blockSize = 512;
+        ///STREAMING_BACKEND frames the audio in blocks of blockSize, independently of the reads,
+        ///and only computes the values of ofxaa::StreamingNetwork::computesValue()
+        ofxaa::NetworkBackend backend = ofxaa::STANDARD_BACKEND;
+    };
+
+    ///Per-frame descriptor values. Every subscribed value has two columns: NAME, the smoothed
+    ///normalized value the plug-in sends over OSC, and NAME.raw, the smoothed raw value.
+    struct FeatureStream {
+        int sampleRate = 0;
+        int blockSize = 0;
+        std::vector<ofxaa::FeatureColumn> columns;
+        ///numFrames rows of columns.size() values
+        std::vector<float> values;
+
+        int64_t getNumFrames() const { return columns.empty() ? 0 : (int64_t)(values.size() / columns.size()); }
+    };
+
+    ///Splits one file in chunks analyzed in parallel.
+    struct ChunkSettings {
+        ///Length of each chunk, rounded to whole blocks
+        double chunkSeconds = 60.0;
+        ///Audio analyzed before each chunk and discarded, so the smoothing, filters and onset
+        ///history of the chunk start from the state a sequential run would have. Raised to
+        ///ADAPTIVE_WARMUP_TIME_CONSTANTS times the longest adaptation of the meters.
+        double warmupSeconds = 5.0;
+        int jobs = 1;
+    };
+
+    ///Runs an ofxAudioAnalyzer set up like the plug-in over the whole input, one frame per block.
+    bool analyze(AudioInput& input, const AnalysisSettings& settings, FeatureStream& features, std::string& error);
+
+    ///Same result as analyze(), within the tolerance allowed by the warm-up, using up to
+    ///chunks.jobs threads. Each thread reads its own clone() of the input.
+    ///Falls back to analyze() when the warm-up would be longer than a chunk.
+    bool analyzeChunked(AudioInput& input, const AnalysisSettings& settings, const ChunkSettings& chunks,
+                        FeatureStream& features, std::string& error);
+
+    ///Largest absolute difference between two streams of the same analysis, and the column where
+    ///it is. Infinity if their shapes differ.
+    float maxDifference(const FeatureStream& a, const FeatureStream& b, std::string& column);
+
+    ///frame,time,<columns> with time in seconds at the start of the frame.
+    void writeCsv(const FeatureStream& features, std::ostream& stream);
+
+    ///Same values as a feature file (see ofxAAFeatureFile.h), hop size = block size.
+    bool writeFeatureFile(const FeatureStream& features, const std::string& path, std::string& error);
+}}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "FeatureCache.h"
+#include "ValueNames.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+namespace ofxaa { namespace batch {
+
+    //MARK: - Hash
+
+    ///Two independent 64 bit lanes over 8 byte words
+    class ContentHash {
+    public:
+        void add(const void* data, size_t size){
+            auto bytes = static_cast<const uint8_t*>(data);
+            size_t words = size / 8;
+            for (size_t i=0; i<words; i++){
+                uint64_t word;
+                std::memcpy(&word, bytes + i * 8, 8);
+                addWord(word);
+            }
+            uint64_t tail = 0;
+            std::memcpy(&tail, bytes + words * 8, size % 8);
+            addWord(tail ^ (uint64_t(size % 8) << 56));
+            length += size;
+        }
+
+        std::string hex(){
+            char text[33];
+            std::snprintf(text, sizeof(text), "%016llx%016llx",
+                          (unsigned long long)mix(a ^ length), (unsigned long long)mix(b + length));
+            return text;
+        }
+
+    private:
+        static uint64_t rotate(uint64_t x, int bits){ return (x << bits) | (x >> (64 - bits)); }
+        ///MurmurHash3 finalizer
+        static uint64_t mix(uint64_t x){
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return x;
+        }
+        void addWord(uint64_t word){
+            a = rotate(a ^ word, 31) * 0x9E3779B97F4A7C15ULL;
+            b = rotate(b + word, 27) * 0xC2B2AE3D27D4EB4FULL + 0x165667B19E3779F9ULL;
+        }
+
+        uint64_t a = 0x243F6A8885A308D3ULL;
+        uint64_t b = 0x13198A2E03707344ULL;
+        uint64_t length = 0;
+    };
+    //----------------------------------------------
+    std::string hashAudio(AudioInput& input){
+        ContentHash hash;
+        int32_t format[2] = { input.getSampleRate(), input.getNumChannels() };
+        hash.add(format, sizeof(format));
+
+        const int blockFrames = 65536;
+        std::vector<float> block(size_t(blockFrames) * input.getNumChannels());
+        input.seek(0);
+        int frames;
+        while ((frames = input.read(block.data(), blockFrames)) > 0){
+            hash.add(block.data(), size_t(frames) * input.getNumChannels() * sizeof(float));
+        }
+        input.seek(0);
+        return hash.hex();
+    }
+
+    //MARK: - Cache
+
+    FeatureCache::FeatureCache(const std::string& directory, const std::string& mode, AnalyzeFunction analyzeFunction)
+        : directory(directory), mode(mode), analyzeFunction(std::move(analyzeFunction)) {}
+    //----------------------------------------------
+    std::string FeatureCache::pathFor(const std::string& audioHash, const AudioInput& input, int blockSize,
+                                      ofxAAValue value, const AnalysisSettings& settings) const {
+        ///the settings analyze() applies for the value: the last meter's smoothing and
+        ///normalization, the last max estimated value different from 1.0
+        float smoothing = 0.0;
+        float maxEstimated = 1.0;
+        float adaptationSeconds = 0.0;
+        for (auto& meter : settings.meters){
+            if (meter.value != value) continue;
+            smoothing = meter.smoothing;
+            adaptationSeconds = meter.adaptationSeconds;
+            if (meter.maxEstimated != 1.0) maxEstimated = meter.maxEstimated;
+        }
+
+        std::ostringstream key;
+        key.precision(9);
+        key << FEATURE_CACHE_VERSION << "|" << input.getSampleRate() << "|" << input.getNumChannels()
+            << "|" << blockSize << "|" << smoothing << "|" << maxEstimated
+            << "|" << adaptationSeconds << "|" << mode;
+        ContentHash hash;
+        auto text = key.str();
+        hash.add(text.data(), text.size());
+
+        return directory + "/" + audioHash + "/" + utils::valueTypeToString(value) + "-" + hash.hex().substr(0, 16) + ".features";
+    }
+    //----------------------------------------------
+    bool FeatureCache::load(const std::string& path, FeatureStream& features) const {
+        FeatureFileReader reader;
+        std::string error;
+        if (!reader.open(path, error) || reader.getColumns().size() != 2) return false;
+
+        features.sampleRate = reader.getSampleRate();
+        features.blockSize = reader.getHopSize();
+        features.columns = reader.getColumns();
+        features.values.resize(size_t(reader.getNumRows()) * 2);
+        for (int64_t row=0; row<reader.getNumRows(); row++){
+            features.values[row * 2] = reader.getValue(0, row);
+            features.values[row * 2 + 1] = reader.getValue(1, row);
+        }
+        return true;
+    }
+    //----------------------------------------------
+    bool FeatureCache::store(const std::string& path, const FeatureStream& features, size_t firstColumn, std::string& error) const {
+        FeatureStream entry;
+        entry.sampleRate = features.sampleRate;
+        entry.blockSize = features.blockSize;
+        entry.columns.assign(features.columns.begin() + firstColumn, features.columns.begin() + firstColumn + 2);
+        auto numColumns = features.columns.size();
+        entry.values.reserve(size_t(features.getNumFrames()) * 2);
+        for (int64_t frame=0; frame<features.getNumFrames(); frame++){
+            entry.values.push_back(features.values[frame * numColumns + firstColumn]);
+            entry.values.push_back(features.values[frame * numColumns + firstColumn + 1]);
+        }
+
+        ///written next to the entry and renamed, so concurrent jobs never read a partial file
+        std::error_code fileError;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), fileError);
+        std::ostringstream temporaryName;
+        temporaryName << path << ".tmp" << std::this_thread::get_id();
+        auto temporary = temporaryName.str();
+        if (!writeFeatureFile(entry, temporary, error)) return false;
+        std::filesystem::rename(temporary, path, fileError);
+        if (fileError){
+            error = "can't store " + path;
+            std::filesystem::remove(temporary, fileError);
+            return false;
+        }
+        return true;
+    }
+    //----------------------------------------------
+    bool FeatureCache::analyze(AudioInput& input, const AnalysisSettings& settings, FeatureStream& features,
+                               int& cachedValues, std::string& error){
+        cachedValues = 0;
+        auto audioHash = hashAudio(input);
+
+        ///distinct values in meter order, like analyze()
+        std::vector<ofxAAValue> values;
+        for (auto& meter : settings.meters){
+            if (meter.value != NONE && std::find(values.begin(), values.end(), meter.value) == values.end()){
+                values.push_back(meter.value);
+            }
+        }
+        if (values.empty()){
+            error = "no descriptors selected";
+            return false;
+        }
+
+        std::vector<FeatureStream> cached(values.size());
+        std::vector<bool> isCached(values.size(), false);
+        AnalysisSettings missing = settings;
+        missing.meters.clear();
+        for (size_t v=0; v<values.size(); v++){
+            isCached[v] = load(pathFor(audioHash, input, settings.blockSize, values[v], settings), cached[v]);
+            if (isCached[v]){
+                cachedValues++;
+                continue;
+            }
+            for (auto& meter : settings.meters){
+                if (meter.value == values[v]) missing.meters.push_back(meter);
+            }
+        }
+
+        FeatureStream analyzed;
+        if (!missing.meters.empty()){
+            if (!analyzeFunction(input, missing, analyzed, error)) return false;
+        }
+
+        ///columns in the order of values, two per value
+        features.sampleRate = input.getSampleRate();
+        features.blockSize = settings.blockSize;
+        features.columns.clear();
+        int64_t numFrames = -1;
+        std::vector<std::pair<const FeatureStream*, size_t>> sources;
+        size_t analyzedColumn = 0;
+        for (size_t v=0; v<values.size(); v++){
+            const FeatureStream* source = isCached[v] ? &cached[v] : &analyzed;
+            size_t firstColumn = isCached[v] ? 0 : analyzedColumn;
+            if (!isCached[v]){
+                analyzedColumn += 2;
+                if (!store(pathFor(audioHash, input, settings.blockSize, values[v], settings), analyzed, firstColumn, error)){
+                    return false;
+                }
+            }
+            if (numFrames >= 0 && source->getNumFrames() != numFrames){
+                error = "cached entries of different lengths, clear the cache";
+                return false;
+            }
+            numFrames = source->getNumFrames();
+            features.columns.push_back(source->columns[firstColumn]);
+            features.columns.push_back(source->columns[firstColumn + 1]);
+            sources.push_back({ source, firstColumn });
+        }
+
+        auto numColumns = features.columns.size();
+        features.values.resize(size_t(numFrames) * numColumns);
+        for (int64_t frame=0; frame<numFrames; frame++){
+            float* row = features.values.data() + frame * numColumns;
+            for (auto& source : sources){
+                auto sourceColumns = source.first->columns.size();
+                const float* values = source.first->values.data() + frame * sourceColumns + source.second;
+                *row++ = values[0];
+                *row++ = values[1];
+            }
+        }
+        return true;
+    }
+}}
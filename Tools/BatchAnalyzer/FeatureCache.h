@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "BatchAnalyzer.h"
+
+#include <functional>
+
+///Bump when a change to the analysis makes earlier results invalid
+#define FEATURE_CACHE_VERSION 2
+
+namespace ofxaa { namespace batch {
+
+    ///Content hash of the decoded audio (samples, sample rate and channels), 32 hex characters.
+    ///Not cryptographic. Reads the whole input and seeks it back to the start.
+    std::string hashAudio(AudioInput& input);
+
+    ///Analysis results stored by content: <directory>/<audio hash>/<VALUE>-<settings hash>.features,
+    ///one file per descriptor. The settings hash covers everything the values of one descriptor
+    ///depend on: sample rate, block size, channels, its smoothing and max estimated value, the
+    ///analysis mode (sequential or chunked) and FEATURE_CACHE_VERSION.
+    ///
+    ///Since every descriptor is its own entry, adding descriptors only analyzes the new ones.
+    class FeatureCache {
+    public:
+        typedef std::function<bool(AudioInput&, const AnalysisSettings&, FeatureStream&, std::string&)> AnalyzeFunction;
+
+        ///\param mode: describes how analyzeFunction analyzes, part of the key
+        FeatureCache(const std::string& directory, const std::string& mode, AnalyzeFunction analyzeFunction);
+
+        ///Same result as analyzeFunction(input, settings, ...). cachedValues is the number of
+        ///descriptors that were read from the cache instead of analyzed.
+        bool analyze(AudioInput& input, const AnalysisSettings& settings, FeatureStream& features,
+                     int& cachedValues, std::string& error);
+
+    private:
+        std::string pathFor(const std::string& audioHash, const AudioInput& input, int blockSize,
+                            ofxAAValue value, const AnalysisSettings& settings) const;
+        bool load(const std::string& path, FeatureStream& features) const;
+        bool store(const std::string& path, const FeatureStream& features, size_t firstColumn, std::string& error) const;
+
+        std::string directory;
+        std::string mode;
+        AnalyzeFunction analyzeFunction;
+    };
+}}
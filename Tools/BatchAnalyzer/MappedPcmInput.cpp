@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "MappedPcmInput.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define MAPPED_PCM_AVAILABLE 1
+#endif
+
+#define WAVE_FORMAT_PCM 0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+namespace ofxaa { namespace batch {
+
+    //MARK: - Byte order
+
+    static uint16_t readLE16(const uint8_t* p){ return uint16_t(p[0] | p[1] << 8); }
+    static uint32_t readLE32(const uint8_t* p){ return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24; }
+    static uint64_t readLE64(const uint8_t* p){ return uint64_t(readLE32(p)) | uint64_t(readLE32(p + 4)) << 32; }
+    static uint16_t readBE16(const uint8_t* p){ return uint16_t(p[0] << 8 | p[1]); }
+    static uint32_t readBE32(const uint8_t* p){ return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]); }
+
+    ///80 bit IEEE 754 extended, the AIFF sample rate
+    static double readExtended(const uint8_t* p){
+        int exponent = ((p[0] & 0x7F) << 8) | p[1];
+        uint64_t mantissa = uint64_t(readBE32(p + 2)) << 32 | readBE32(p + 6);
+        if (exponent == 0 && mantissa == 0) return 0.0;
+        double value = std::ldexp((double)mantissa, exponent - 16383 - 63);
+        return (p[0] & 0x80) ? -value : value;
+    }
+
+    //MARK: - Conversion
+    //
+    // Plain loops over the mapped bytes, without branches on the sample values,
+    // so the compiler can vectorize them. Byte order is handled per sample, which
+    // keeps them independent of the host byte order.
+
+    template <bool BigEndian>
+    static void convertInt16(const uint8_t* in, float* out, size_t count){
+        for (size_t i=0; i<count; i++){
+            const uint8_t* p = in + 2 * i;
+            auto value = int16_t(BigEndian ? (p[0] << 8 | p[1]) : (p[1] << 8 | p[0]));
+            out[i] = value * (1.0f / 32768.0f);
+        }
+    }
+
+    template <bool BigEndian>
+    static void convertInt24(const uint8_t* in, float* out, size_t count){
+        for (size_t i=0; i<count; i++){
+            const uint8_t* p = in + 3 * i;
+            uint32_t bits = BigEndian ? (uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8)
+                                      : (uint32_t(p[2]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[0]) << 8);
+            out[i] = int32_t(bits) * (1.0f / 2147483648.0f);
+        }
+    }
+
+    template <bool BigEndian>
+    static void convertInt32(const uint8_t* in, float* out, size_t count){
+        for (size_t i=0; i<count; i++){
+            uint32_t bits = BigEndian ? readBE32(in + 4 * i) : readLE32(in + 4 * i);
+            out[i] = int32_t(bits) * (1.0f / 2147483648.0f);
+        }
+    }
+
+    template <bool BigEndian>
+    static void convertFloat32(const uint8_t* in, float* out, size_t count){
+        for (size_t i=0; i<count; i++){
+            uint32_t bits = BigEndian ? readBE32(in + 4 * i) : readLE32(in + 4 * i);
+            std::memcpy(out + i, &bits, sizeof(float));
+        }
+    }
+
+    template <bool BigEndian>
+    static void convertFloat64(const uint8_t* in, float* out, size_t count){
+        for (size_t i=0; i<count; i++){
+            const uint8_t* p = in + 8 * i;
+            uint64_t bits = BigEndian ? (uint64_t(readBE32(p)) << 32 | readBE32(p + 4)) : readLE64(p);
+            double value;
+            std::memcpy(&value, &bits, sizeof(double));
+            out[i] = (float)value;
+        }
+    }
+
+    template <bool BigEndian>
+    static void convert(MappedPcmInput::SampleFormat format, const uint8_t* in, float* out, size_t count){
+        switch (format) {
+            case MappedPcmInput::INT16: convertInt16<BigEndian>(in, out, count); break;
+            case MappedPcmInput::INT24: convertInt24<BigEndian>(in, out, count); break;
+            case MappedPcmInput::INT32: convertInt32<BigEndian>(in, out, count); break;
+            case MappedPcmInput::FLOAT32: convertFloat32<BigEndian>(in, out, count); break;
+            case MappedPcmInput::FLOAT64: convertFloat64<BigEndian>(in, out, count); break;
+        }
+    }
+
+#if MAPPED_PCM_AVAILABLE
+
+    //MARK: - File
+
+    std::unique_ptr<MappedPcmInput> MappedPcmInput::open(const std::string& path, std::string& error){
+        std::unique_ptr<MappedPcmInput> input(new MappedPcmInput());
+        input->fd = ::open(path.c_str(), O_RDONLY);
+        if (input->fd < 0){
+            error = "can't open " + path;
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(input->fd, &info) != 0){
+            error = "can't read " + path;
+            return nullptr;
+        }
+        input->fileSize = (uint64_t)info.st_size;
+
+        uint8_t header[12];
+        if (!input->readAt(0, header, sizeof(header))){
+            error = "not a WAV or AIFF file";
+            return nullptr;
+        }
+        bool ok;
+        if ((std::memcmp(header, "RIFF", 4) == 0 || std::memcmp(header, "RF64", 4) == 0) && std::memcmp(header + 8, "WAVE", 4) == 0){
+            ok = input->parseWave(error);
+        } else if (std::memcmp(header, "FORM", 4) == 0 && (std::memcmp(header + 8, "AIFF", 4) == 0 || std::memcmp(header + 8, "AIFC", 4) == 0)){
+            ok = input->parseAiff(error);
+        } else {
+            error = "not a WAV or AIFF file";
+            ok = false;
+        }
+        if (!ok) return nullptr;
+
+        ///never read past the end of a truncated file
+        uint64_t frameBytes = uint64_t(input->bytesPerSample) * input->_channels;
+        uint64_t available = input->fileSize > input->dataOffset ? input->fileSize - input->dataOffset : 0;
+        input->numFrames = std::min<int64_t>(input->numFrames, available / frameBytes);
+        return input;
+    }
+    //----------------------------------------------
+    std::unique_ptr<AudioInput> MappedPcmInput::clone() const {
+        std::unique_ptr<MappedPcmInput> input(new MappedPcmInput(*this));
+        input->fd = dup(fd);
+        if (input->fd < 0) return nullptr;
+        input->position = 0;
+        input->window = nullptr;
+        input->windowOffset = 0;
+        input->windowSize = 0;
+        return input;
+    }
+    //----------------------------------------------
+    MappedPcmInput::~MappedPcmInput(){
+        unmap();
+        if (fd >= 0) ::close(fd);
+    }
+    //----------------------------------------------
+    bool MappedPcmInput::readAt(uint64_t offset, void* destination, size_t size) const {
+        return pread(fd, destination, size, (off_t)offset) == (ssize_t)size;
+    }
+    //----------------------------------------------
+    bool MappedPcmInput::setFormat(int bitsPerSample, bool isFloat, std::string& error){
+        if (isFloat && bitsPerSample == 32) format = FLOAT32;
+        else if (isFloat && bitsPerSample == 64) format = FLOAT64;
+        else if (!isFloat && bitsPerSample == 16) format = INT16;
+        else if (!isFloat && bitsPerSample == 24) format = INT24;
+        else if (!isFloat && bitsPerSample == 32) format = INT32;
+        else {
+            error = "unsupported sample format: " + std::to_string(bitsPerSample) + (isFloat ? " bit float" : " bit integer");
+            return false;
+        }
+        bytesPerSample = bitsPerSample / 8;
+        return true;
+    }
+    //----------------------------------------------
+    bool MappedPcmInput::parseWave(std::string& error){
+        uint8_t header[12];
+        readAt(0, header, sizeof(header));
+        bool isRf64 = std::memcmp(header, "RF64", 4) == 0;
+        isBigEndian = false;
+
+        uint64_t rf64DataSize = 0;
+        bool hasFormat = false;
+        uint64_t offset = 12;
+        while (offset + 8 <= fileSize){
+            uint8_t chunk[8];
+            if (!readAt(offset, chunk, sizeof(chunk))) break;
+            uint64_t size = readLE32(chunk + 4);
+            uint64_t body = offset + 8;
+
+            if (std::memcmp(chunk, "ds64", 4) == 0){
+                uint8_t ds64[24];
+                if (!readAt(body, ds64, sizeof(ds64))) break;
+                rf64DataSize = readLE64(ds64 + 8);
+            } else if (std::memcmp(chunk, "fmt ", 4) == 0){
+                uint8_t fmt[40] = {};
+                if (size < 16 || !readAt(body, fmt, std::min<uint64_t>(size, sizeof(fmt)))){
+                    error = "invalid fmt chunk";
+                    return false;
+                }
+                int formatTag = readLE16(fmt);
+                _channels = readLE16(fmt + 2);
+                _samplerate = (int)readLE32(fmt + 4);
+                int bitsPerSample = readLE16(fmt + 14);
+                if (formatTag == WAVE_FORMAT_EXTENSIBLE && size >= 26){
+                    ///the sub format GUID starts with the format tag
+                    formatTag = readLE16(fmt + 24);
+                }
+                if (formatTag != WAVE_FORMAT_PCM && formatTag != WAVE_FORMAT_IEEE_FLOAT){
+                    error = "compressed WAV (format " + std::to_string(formatTag) + ")";
+                    return false;
+                }
+                if (!setFormat(bitsPerSample, formatTag == WAVE_FORMAT_IEEE_FLOAT, error)) return false;
+                hasFormat = true;
+            } else if (std::memcmp(chunk, "data", 4) == 0){
+                if (!hasFormat || _channels <= 0){
+                    error = "data before fmt chunk";
+                    return false;
+                }
+                if (isRf64 && size == 0xFFFFFFFF){
+                    size = rf64DataSize;
+                }
+                dataOffset = body;
+                numFrames = int64_t(size / (uint64_t(bytesPerSample) * _channels));
+                return true;
+            }
+            offset = body + size + (size & 1);
+        }
+        error = "no audio data";
+        return false;
+    }
+    //----------------------------------------------
+    bool MappedPcmInput::parseAiff(std::string& error){
+        uint8_t header[12];
+        readAt(0, header, sizeof(header));
+        bool isAifc = std::memcmp(header + 8, "AIFC", 4) == 0;
+
+        bool hasFormat = false;
+        uint64_t offset = 12;
+        while (offset + 8 <= fileSize){
+            uint8_t chunk[8];
+            if (!readAt(offset, chunk, sizeof(chunk))) break;
+            uint64_t size = readBE32(chunk + 4);
+            uint64_t body = offset + 8;
+
+            if (std::memcmp(chunk, "COMM", 4) == 0){
+                uint8_t comm[22] = {};
+                if (size < 18 || !readAt(body, comm, std::min<uint64_t>(size, sizeof(comm)))){
+                    error = "invalid COMM chunk";
+                    return false;
+                }
+                _channels = readBE16(comm);
+                numFrames = readBE32(comm + 2);
+                int bitsPerSample = readBE16(comm + 6);
+                _samplerate = (int)std::lround(readExtended(comm + 8));
+
+                bool isFloat = false;
+                isBigEndian = true;
+                if (isAifc && size >= 22){
+                    if (std::memcmp(comm + 18, "sowt", 4) == 0){
+                        isBigEndian = false;
+                    } else if (std::memcmp(comm + 18, "fl32", 4) == 0 || std::memcmp(comm + 18, "FL32", 4) == 0){
+                        isFloat = true;
+                        bitsPerSample = 32;
+                    } else if (std::memcmp(comm + 18, "fl64", 4) == 0 || std::memcmp(comm + 18, "FL64", 4) == 0){
+                        isFloat = true;
+                        bitsPerSample = 64;
+                    } else if (std::memcmp(comm + 18, "NONE", 4) != 0){
+                        error = "compressed AIFC";
+                        return false;
+                    }
+                }
+                ///sample sizes that aren't a multiple of 8 are stored padded to the next byte
+                bitsPerSample = (bitsPerSample + 7) / 8 * 8;
+                if (!setFormat(bitsPerSample, isFloat, error)) return false;
+                hasFormat = true;
+            } else if (std::memcmp(chunk, "SSND", 4) == 0){
+                uint8_t ssnd[8];
+                if (!readAt(body, ssnd, sizeof(ssnd))){
+                    error = "invalid SSND chunk";
+                    return false;
+                }
+                dataOffset = body + 8 + readBE32(ssnd);
+            }
+            offset = body + size + (size & 1);
+        }
+        if (!hasFormat || dataOffset == 0 || _channels <= 0){
+            error = "no audio data";
+            return false;
+        }
+        return true;
+    }
+
+    //MARK: - Reading
+
+    const uint8_t* MappedPcmInput::map(uint64_t offset, size_t size){
+        if (window != nullptr && offset >= windowOffset && offset + size <= windowOffset + windowSize){
+            return window + (offset - windowOffset);
+        }
+        unmap();
+
+        static const uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+        windowOffset = offset / pageSize * pageSize;
+        windowSize = (size_t)std::min<uint64_t>(std::max<uint64_t>(MAPPED_WINDOW_SIZE, offset - windowOffset + size), fileSize - windowOffset);
+
+        void* address = mmap(nullptr, windowSize, PROT_READ, MAP_PRIVATE, fd, (off_t)windowOffset);
+        if (address == MAP_FAILED){
+            window = nullptr;
+            return nullptr;
+        }
+        madvise(address, windowSize, MADV_SEQUENTIAL);
+        window = static_cast<const uint8_t*>(address);
+        return window + (offset - windowOffset);
+    }
+    //----------------------------------------------
+    void MappedPcmInput::unmap(){
+        if (window != nullptr){
+            munmap(const_cast<uint8_t*>(window), windowSize);
+            window = nullptr;
+        }
+    }
+    //----------------------------------------------
+    void MappedPcmInput::seek(int64_t frame){
+        position = std::max<int64_t>(0, std::min(frame, numFrames));
+    }
+    //----------------------------------------------
+    int MappedPcmInput::read(float* interleaved, int maxFrames){
+        int64_t frameBytes = int64_t(bytesPerSample) * _channels;
+        int frames = (int)std::min<int64_t>(maxFrames, numFrames - position);
+        int done = 0;
+        while (done < frames){
+            uint64_t offset = dataOffset + uint64_t(position) * frameBytes;
+            const uint8_t* data = map(offset, (size_t)frameBytes);
+            if (data == nullptr) break;
+
+            ///frames left in the window
+            int64_t available = int64_t(windowOffset + windowSize - offset) / frameBytes;
+            int count = (int)std::min<int64_t>(frames - done, available);
+
+            float* out = interleaved + int64_t(done) * _channels;
+            size_t samples = size_t(count) * _channels;
+            if (isBigEndian){
+                convert<true>(format, data, out, samples);
+            } else {
+                convert<false>(format, data, out, samples);
+            }
+            position += count;
+            done += count;
+        }
+        return done;
+    }
+
+#else
+
+    std::unique_ptr<MappedPcmInput> MappedPcmInput::open(const std::string&, std::string& error){
+        error = "memory-mapped input not available on this platform";
+        return nullptr;
+    }
+    MappedPcmInput::~MappedPcmInput(){}
+    int MappedPcmInput::read(float*, int){ return 0; }
+    void MappedPcmInput::seek(int64_t){}
+    std::unique_ptr<AudioInput> MappedPcmInput::clone() const { return nullptr; }
+
+#endif
+}}
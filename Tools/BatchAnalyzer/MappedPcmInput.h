@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "AudioInput.h"
+
+#define MAPPED_WINDOW_SIZE (64 * 1024 * 1024)
+
+namespace ofxaa { namespace batch {
+
+    ///Streams uncompressed WAV, RF64 and AIFF/AIFC files (16, 24, 32 bit integer, 32 and 64 bit
+    ///float) through a sliding memory-mapped window, converting to float as frames are read.
+    ///Memory use doesn't depend on the file length: only MAPPED_WINDOW_SIZE bytes are mapped at a time.
+    ///
+    ///Only on POSIX systems, elsewhere open() always fails.
+    class MappedPcmInput : public AudioInput {
+    public:
+        ///nullptr with error set if the file isn't a supported PCM file.
+        static std::unique_ptr<MappedPcmInput> open(const std::string& path, std::string& error);
+
+        ~MappedPcmInput() override;
+
+        int getSampleRate() const override { return _samplerate; }
+        int getNumChannels() const override { return _channels; }
+        int64_t getNumFrames() const override { return numFrames; }
+
+        int read(float* interleaved, int maxFrames) override;
+        void seek(int64_t frame) override;
+        ///Shares the file (a duplicated descriptor) but maps its own window.
+        std::unique_ptr<AudioInput> clone() const override;
+
+        enum SampleFormat {
+            INT16,
+            INT24,
+            INT32,
+            FLOAT32,
+            FLOAT64
+        };
+
+    private:
+        MappedPcmInput() = default;
+        MappedPcmInput(const MappedPcmInput&) = default;
+
+        bool parseWave(std::string& error);
+        bool parseAiff(std::string& error);
+        bool setFormat(int bitsPerSample, bool isFloat, std::string& error);
+        bool readAt(uint64_t offset, void* destination, size_t size) const;
+        ///Maps the window containing [offset, offset + size), returns the address of offset.
+        const uint8_t* map(uint64_t offset, size_t size);
+        void unmap();
+
+        int fd = -1;
+        uint64_t fileSize = 0;
+
+        int _samplerate = 0;
+        int _channels = 0;
+        SampleFormat format = INT16;
+        bool isBigEndian = false;
+        int bytesPerSample = 2;
+        uint64_t dataOffset = 0;
+        int64_t numFrames = 0;
+        int64_t position = 0;
+
+        const uint8_t* window = nullptr;
+        uint64_t windowOffset = 0;
+        size_t windowSize = 0;
+    };
+}}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#include "PluginState.h"
+#include "ValueNames.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+///copyXmlToBinary() writes this magic number and the size before the XML
+#define JUCE_BINARY_STATE_MAGIC "VC2!"
+
+namespace ofxaa { namespace batch {
+
+    ///Value of attribute name="..." inside one tag, empty if missing.
+    static std::string attribute(const std::string& tag, const std::string& name){
+        auto key = " " + name + "=\"";
+        auto start = tag.find(key);
+        if (start == std::string::npos) return "";
+        start += key.size();
+        auto end = tag.find('"', start);
+        if (end == std::string::npos) return "";
+        return tag.substr(start, end - start);
+    }
+    //----------------------------------------------
+    bool loadPluginState(const std::string& path, std::vector<MeterSettings>& meters, std::string& error){
+        std::ifstream file(path, std::ios::binary);
+        if (!file){
+            error = "can't open " + path;
+            return false;
+        }
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (content.compare(0, 4, JUCE_BINARY_STATE_MAGIC) == 0 && content.size() > 8){
+            content = std::string(content.c_str() + 8);
+        }
+
+        ///APVTS stores parameters as <PARAM id="algorithmType:0" value="1.0"/>
+        std::map<std::string, float> parameters;
+        size_t position = 0;
+        while ((position = content.find("<PARAM ", position)) != std::string::npos){
+            auto end = content.find('>', position);
+            if (end == std::string::npos) break;
+            auto tag = content.substr(position, end - position);
+            auto id = attribute(tag, "id");
+            auto value = attribute(tag, "value");
+            if (!id.empty() && !value.empty()){
+                parameters[id] = (float)std::atof(value.c_str());
+            }
+            position = end;
+        }
+        if (parameters.empty()){
+            error = path + " has no plug-in parameters";
+            return false;
+        }
+
+        meters.clear();
+        for (int idx=0; ; idx++){
+            auto suffix = ":" + std::to_string(idx);
+            auto type = parameters.find("algorithmType" + suffix);
+            if (type == parameters.end()) break;
+
+            MeterSettings meter;
+            meter.value = utils::choiceIndexToValueType((int)std::lround(type->second));
+            if (parameters.count("smoothing" + suffix)) meter.smoothing = parameters["smoothing" + suffix];
+            if (parameters.count("maxEstimated" + suffix)) meter.maxEstimated = parameters["maxEstimated" + suffix];
+            if (parameters.count("normalization" + suffix) && std::lround(parameters["normalization" + suffix]) == 1){
+                meter.adaptationSeconds = parameters.count("adaptationTime" + suffix) ? parameters["adaptationTime" + suffix]
+                                                                                      : ADAPTIVE_NORMALIZATION_SECONDS;
+            }
+            meters.push_back(meter);
+        }
+        if (meters.empty()){
+            error = path + " has no meter parameters";
+            return false;
+        }
+        return true;
+    }
+}}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+#pragma once
+
+#include "ofxAAValues.h"
+
+#include <string>
+#include <vector>
+
+namespace ofxaa { namespace batch {
+
+    ///Parameters of one MeterUnit of the plug-in.
+    struct MeterSettings {
+        ofxAAValue value = NONE;
+        float smoothing = 0.0;
+        ///The plug-in only applies it when it differs from the parameter default (1.0).
+        float maxEstimated = 1.0;
+        ///Window of the adaptive normalization (normalization:N = 1, adaptationTime:N),
+        ///0 for the max estimated normalization.
+        float adaptationSeconds = 0.0;
+    };
+
+    ///Reads the meter parameters (algorithmType:N, smoothing:N, maxEstimated:N, normalization:N,
+    ///adaptationTime:N) from a plug-in
+    ///state: the XML written by getStateInformation(), with or without JUCE's binary header.
+    ///Meters are ordered by index, meters set to -NONE- are kept with value NONE.
+    bool loadPluginState(const std::string& path, std::vector<MeterSettings>& meters, std::string& error);
+}}
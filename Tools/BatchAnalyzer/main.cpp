@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2021 Leo Zimmerman [http://www.leozimmerman.com.ar]
+ *
+ * ofxAudioAnalyzer is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation (FSF), either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the Affero GNU General Public License
+ * version 3 along with this program.  If not, see http://www.gnu.org/licenses/
+ *
+ * ---------------------------------------------------------------
+ *
+ * This project uses Essentia, copyrighted by Music Technology Group - Universitat Pompeu Fabra
+ * using GNU Affero General Public License.
+ * See http://essentia.upf.edu for documentation.
+ *
+ */
+
+// Runs the plug-in analysis over audio files, faster than realtime, and writes the per-frame
+// values the plug-in would have sent over OSC. Files are analyzed in parallel.
+//
+// usage: essentialight_batch [--state FILE | --values RMS,POWER,...] [--block-size N]
+//                            [--jobs N] [--out-dir DIR] [--format csv|features]
+//                            [--chunk-seconds S [--warmup-seconds S] [--verify [--tolerance T]]]
+//                            [--cache DIR] [--backend standard|streaming] FILE...
+//
+// --state reads the meters from a saved plug-in state, --values subscribes the given values
+// without smoothing. Each input writes <out-dir>/<file name>.csv, or <file name>.features with
+// --format features (the columnar feature file of ofxAAFeatureFile.h).
+//
+// --chunk-seconds analyzes the files one after the other instead, each split in chunks that run
+// in parallel (see analyzeChunked). --verify also runs the sequential analysis and fails if any
+// value differs by more than the tolerance (default 0.001).
+//
+// --cache keeps the results of every descriptor in DIR, keyed by the audio content and the
+// analysis settings (see FeatureCache.h). Unchanged files are not analyzed again, and adding
+// descriptors only analyzes the new ones.
+//
+// --backend streaming computes the descriptors with Essentia's streaming scheduler (see
+// ofxAAStreamingNetwork.h) instead of one standard compute() per block. It only computes RMS,
+// POWER and LOUDNESS, other values are an error.
+
+#include "BatchAnalyzer.h"
+#include "FeatureCache.h"
+#include "ValueNames.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace ofxaa::batch;
+
+struct Options {
+    std::string statePath;
+    std::string valueNames;
+    std::string outputDirectory = ".";
+    std::string cacheDirectory;
+    bool writeFeatures = false;
+    int jobs = 0;
+    AnalysisSettings settings;
+    ChunkSettings chunks;
+    bool chunked = false;
+    bool verify = false;
+    float tolerance = 1e-3;
+    std::vector<std::string> files;
+};
+
+static void printUsage(){
+    std::cerr << "usage: essentialight_batch [--state FILE | --values RMS,POWER,...] [--block-size N]"
+                 " [--jobs N] [--out-dir DIR] [--format csv|features] [--chunk-seconds S [--warmup-seconds S] [--verify [--tolerance T]]]"
+                 " [--cache DIR] [--backend standard|streaming] FILE..." << std::endl;
+}
+
+static bool parseValues(const std::string& names, std::vector<MeterSettings>& meters){
+    std::istringstream stream(names);
+    std::string name;
+    while (std::getline(stream, name, ',')){
+        MeterSettings meter;
+        meter.value = utils::stringToValueType(name);
+        if (meter.value == NONE){
+            std::cerr << "Unknown value " << name << std::endl;
+            return false;
+        }
+        meters.push_back(meter);
+    }
+    return !meters.empty();
+}
+
+static std::string outputPathFor(const std::string& file, const Options& options){
+    auto slash = file.find_last_of("/\\");
+    auto name = slash == std::string::npos ? file : file.substr(slash + 1);
+    return options.outputDirectory + "/" + name + (options.writeFeatures ? ".features" : ".csv");
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+///Chunked analysis, and the sequential comparison if requested
+static bool analyzeChunks(AudioInput& input, const Options& options, FeatureStream& features, std::string& error){
+    if (!analyzeChunked(input, options.settings, options.chunks, features, error)) return false;
+    if (!options.verify) return true;
+
+    auto reader = input.clone();
+    FeatureStream sequential;
+    if (reader == nullptr || !analyze(*reader, options.settings, sequential, error)){
+        if (error.empty()) error = "can't open another reader of the input";
+        return false;
+    }
+    std::string column;
+    float difference = maxDifference(features, sequential, column);
+    if (difference > options.tolerance){
+        error = "chunked analysis differs from sequential by " + std::to_string(difference)
+                + (column.empty() ? "" : " in " + column);
+        return false;
+    }
+    std::cerr << "verified, max difference " << difference << (column.empty() ? "" : " in " + column) << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]){
+    Options options;
+    for (int i=1; i<argc; i++){
+        std::string arg = argv[i];
+        if (arg == "--state" && i + 1 < argc){
+            options.statePath = argv[++i];
+        } else if (arg == "--values" && i + 1 < argc){
+            options.valueNames = argv[++i];
+        } else if (arg == "--block-size" && i + 1 < argc){
+            options.settings.blockSize = std::atoi(argv[++i]);
+        } else if (arg == "--jobs" && i + 1 < argc){
+            options.jobs = std::atoi(argv[++i]);
+        } else if (arg == "--out-dir" && i + 1 < argc){
+            options.outputDirectory = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc){
+            std::string format = argv[++i];
+            if (format != "csv" && format != "features"){
+                printUsage();
+                return 1;
+            }
+            options.writeFeatures = format == "features";
+        } else if (arg == "--chunk-seconds" && i + 1 < argc){
+            options.chunks.chunkSeconds = std::atof(argv[++i]);
+            options.chunked = true;
+        } else if (arg == "--warmup-seconds" && i + 1 < argc){
+            options.chunks.warmupSeconds = std::atof(argv[++i]);
+        } else if (arg == "--verify"){
+            options.verify = true;
+        } else if (arg == "--tolerance" && i + 1 < argc){
+            options.tolerance = (float)std::atof(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc){
+            options.cacheDirectory = argv[++i];
+        } else if (arg == "--backend" && i + 1 < argc){
+            std::string backend = argv[++i];
+            if (backend != "standard" && backend != "streaming"){
+                printUsage();
+                return 1;
+            }
+            options.settings.backend = backend == "streaming" ? ofxaa::STREAMING_BACKEND : ofxaa::STANDARD_BACKEND;
+        } else if (arg.compare(0, 2, "--") == 0){
+            printUsage();
+            return 1;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    if (options.files.empty() || options.settings.blockSize <= 0
+        || options.statePath.empty() == options.valueNames.empty()
+        || (options.chunked && options.chunks.chunkSeconds <= 0) || (options.verify && !options.chunked)){
+        printUsage();
+        return 1;
+    }
+
+    if (!options.statePath.empty()){
+        std::string error;
+        if (!loadPluginState(options.statePath, options.settings.meters, error)){
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    } else if (!parseValues(options.valueNames, options.settings.meters)){
+        printUsage();
+        return 1;
+    }
+
+    ///once, before the worker threads create algorithms
+    essentia::init();
+
+    int jobs = options.jobs > 0 ? options.jobs : (int)std::max(1u, std::thread::hardware_concurrency());
+    if (options.chunked){
+        ///the threads work on the chunks of one file at a time
+        options.chunks.jobs = jobs;
+        jobs = 1;
+    }
+    jobs = std::min(jobs, (int)options.files.size());
+
+    std::atomic<size_t> nextFile { 0 };
+    std::atomic<int> failures { 0 };
+    std::mutex outputMutex;
+
+    ///the mode is part of the cache key: chunked results may differ slightly from sequential ones
+    std::string cacheMode = options.chunked ? "chunked " + std::to_string(options.chunks.chunkSeconds)
+                                              + " " + std::to_string(options.chunks.warmupSeconds)
+                                            : "sequential";
+    if (options.settings.backend == ofxaa::STREAMING_BACKEND) cacheMode += " streaming";
+    FeatureCache cache(options.cacheDirectory, cacheMode,
+                       [&options](AudioInput& input, const AnalysisSettings& settings, FeatureStream& features, std::string& error){
+                           if (!options.chunked) return analyze(input, settings, features, error);
+                           Options subset = options;
+                           subset.settings = settings;
+                           return analyzeChunks(input, subset, features, error);
+                       });
+
+    auto worker = [&]{
+        for (size_t index = nextFile++; index < options.files.size(); index = nextFile++){
+            auto& file = options.files[index];
+            auto start = std::chrono::steady_clock::now();
+            std::string error;
+
+            auto input = openAudioInput(file, error);
+            FeatureStream features;
+            int cachedValues = 0;
+            bool ok = input != nullptr
+                && (!options.cacheDirectory.empty() ? cache.analyze(*input, options.settings, features, cachedValues, error)
+                    : options.chunked ? analyzeChunks(*input, options, features, error)
+                                      : analyze(*input, options.settings, features, error));
+            if (ok && options.writeFeatures){
+                ok = writeFeatureFile(features, outputPathFor(file, options), error);
+            } else if (ok){
+                std::ofstream stream(outputPathFor(file, options));
+                writeCsv(features, stream);
+                ok = stream.good();
+                if (!ok) error = "can't write " + outputPathFor(file, options);
+            }
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            if (ok){
+                double audioSeconds = double(input->getNumFrames()) / input->getSampleRate();
+                double elapsed = secondsSince(start);
+                std::cerr << file << ": " << features.getNumFrames() << " frames, "
+                          << audioSeconds << " s in " << elapsed << " s ("
+                          << (elapsed > 0 ? audioSeconds / elapsed : 0.0) << "x realtime)";
+                if (cachedValues > 0){
+                    std::cerr << ", " << cachedValues << " of " << features.columns.size() / 2 << " descriptors cached";
+                }
+                std::cerr << std::endl;
+            } else {
+                std::cerr << file << ": " << error << std::endl;
+                failures++;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int j=1; j<jobs; j++){
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads){
+        thread.join();
+    }
+
+    essentia::shutdown();
+    return failures > 0 ? 1 : 0;
+}
@@ -105,10 +105,14 @@ MagicPluginEditor::MagicPluginEditor (MagicProcessorState& stateToUse, std::uniq
     mainIDLabel.addListener(this);
     
     updateOscLabelsTexts(false);
+
+    processorState.setEditorAttached (true);
 }
 
 MagicPluginEditor::~MagicPluginEditor()
 {
+    processorState.setEditorAttached (false);
+
 #if JUCE_MODULE_AVAILABLE_juce_opengl && FOLEYS_ENABLE_OPEN_GL_CONTEXT
     oglContext.detach();
 #endif
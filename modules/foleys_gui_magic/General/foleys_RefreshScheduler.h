@@ -0,0 +1,83 @@
+/*
+ ==============================================================================
+    Copyright (c) 2019-2021 Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    License for non-commercial projects:
+
+    Redistribution and use in source and binary forms, with or without modification,
+    are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    License for commercial products:
+
+    To sell commercial products containing this module, you are required to buy a
+    License from https://foleysfinest.com/developer/pluginguimagic/
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+ ==============================================================================
+ */
+
+#pragma once
+
+namespace foleys
+{
+
+/**
+ One timer on the message thread that drives the continuous redraw of all visualisers
+ in the process, instead of one timer per widget. It is loaded via SharedResourcePointer,
+ so all open editors of all plugin instances share it.
+
+ Clients are asked once per frame if their source data changed and repaint only then.
+ The timer only runs while there are clients registered.
+ */
+class RefreshScheduler : private juce::Timer
+{
+public:
+    struct Client
+    {
+        virtual ~Client() = default;
+
+        /**
+         Called once per frame on the message thread. Check your source and call
+         repaint() if it changed since the last frame.
+         */
+        virtual void refreshIfNeeded() = 0;
+    };
+
+    RefreshScheduler() = default;
+    ~RefreshScheduler() override;
+
+    void addClient (Client* client);
+    void removeClient (Client* client);
+
+    void setRefreshRateHz (int hz);
+
+private:
+    void timerCallback() override;
+
+    juce::ListenerList<Client> clients;
+    int refreshRateHz = 60;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RefreshScheduler)
+};
+
+using SharedRefreshScheduler = juce::SharedResourcePointer<RefreshScheduler>;
+
+} // namespace foleys
@@ -142,6 +142,16 @@ void MagicProcessorState::addOscListener(OscHostListener* listener) {
     oscListener = listener;
 }
 
+void MagicProcessorState::setEditorAttached (bool isAttached)
+{
+    if (isAttached)
+        ++numAttachedEditors;
+    else
+        --numAttachedEditors;
+
+    jassert (numAttachedEditors >= 0);
+}
+
 void MagicProcessorState::setLastHostAddress(juce::String address) {
     auto oscNode = getValueTree().getOrCreateChildWithName (IDs::oscData, nullptr);
     oscNode.setProperty (IDs::hostAddress,  address,  nullptr);
@@ -232,13 +242,14 @@ void MagicProcessorState::setStateInformation (const void* data, int sizeInBytes
     }
 }
 
-void MagicProcessorState::updatePlayheadInformation (juce::AudioPlayHead* playhead)
+bool MagicProcessorState::updatePlayheadInformation (juce::AudioPlayHead* playhead)
 {
     if (playhead == nullptr)
-        return;
+        return false;
 
     juce::AudioPlayHead::CurrentPositionInfo info;
-    playhead->getCurrentPosition (info);
+    if (! playhead->getCurrentPosition (info))
+        return false;
 
     bpm.store (info.bpm);
     timeInSeconds.store (info.timeInSeconds);
@@ -246,6 +257,7 @@ void MagicProcessorState::updatePlayheadInformation (juce::AudioPlayHead* playhe
     timeSigDenominator.store (info.timeSigDenominator);
     isPlaying.store (info.isPlaying);
     isRecording.store (info.isRecording);
+    return true;
 }
 
 void MagicProcessorState::setPlayheadUpdateFrequency (int frequency)
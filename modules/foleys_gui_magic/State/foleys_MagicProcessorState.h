@@ -75,8 +75,15 @@ public:
     /**
      Calling this in the processBlock() will store the values from AudioPlayHead into the state, so it can be used in the GUI.
      To enable this call setPlayheadUpdateFrequency (frequency) with an appropriate value
+     @returns false if the host didn't provide a position, the stored values are unchanged then.
      */
-    void updatePlayheadInformation (juce::AudioPlayHead* playhead);
+    bool updatePlayheadInformation (juce::AudioPlayHead* playhead);
+
+    /**
+     The values stored by the last updatePlayheadInformation(). Safe to call from any thread.
+     */
+    double getPlayheadTimeInSeconds() const { return timeInSeconds.load(); }
+    bool isPlayheadPlaying() const { return isPlaying.load(); }
 
     /**
      Starts the timer to fetch the playhead values from the audio thread
@@ -89,6 +96,13 @@ public:
     void setLastEditorSize (int  width, int  height);
     bool getLastEditorSize (int& width, int& height);
     
+    /**
+     The editor registers itself here, so the processor can skip all visualisation
+     work while no editor is open. Safe to call isEditorAttached() from the audio thread.
+     */
+    void setEditorAttached (bool isAttached);
+    bool isEditorAttached() const { return numAttachedEditors.load (std::memory_order_relaxed) > 0; }
+
     void setLastHostAddress(juce::String address);
     bool getLastHostAddress(juce::String& address);
     
@@ -174,9 +188,11 @@ private:
     std::atomic<double> bpm;
     std::atomic<int>    timeSigNumerator;
     std::atomic<int>    timeSigDenominator;
-    std::atomic<double> timeInSeconds;
-    std::atomic<bool>   isPlaying;
+    std::atomic<double> timeInSeconds { 0.0 };
+    std::atomic<bool>   isPlaying { false };
     std::atomic<bool>   isRecording;
+
+    std::atomic<int>    numAttachedEditors { 0 };
     
     OscHostListener* oscListener;
 
@@ -39,21 +39,60 @@ namespace foleys
 {
 
 void MagicLevelSource::setValues(float value, float normalizedValue) {
-    _value = value;
-    _normalizedValue = normalizedValue;
-    if (value > _maxRegisteredValue) {
-        _maxRegisteredValue = value;
-    }
+    const auto packed = packValues (value, normalizedValue);
+    if (_values.exchange (packed, std::memory_order_release) == packed)
+        return;
+
+    auto max = _maxRegisteredValue.load (std::memory_order_relaxed);
+    while (value > max && ! _maxRegisteredValue.compare_exchange_weak (max, value, std::memory_order_relaxed))
+        ;
+
+    _version.fetch_add (1, std::memory_order_release);
+}
+
+void MagicLevelSource::resetMaxValue()
+{
+    _maxRegisteredValue.store (0.0f);
+    _version.fetch_add (1, std::memory_order_release);
 }
 
 float MagicLevelSource::getValue () const
 {
-    return _value;
+    return unpackValue (_values.load (std::memory_order_acquire));
+}
+
+float MagicLevelSource::getNormalizedValue () const
+{
+    return unpackNormalizedValue (_values.load (std::memory_order_acquire));
 }
 
 float MagicLevelSource::getMaxValue () const
 {
-    return _maxRegisteredValue;
+    return _maxRegisteredValue.load (std::memory_order_relaxed);
+}
+
+juce::uint64 MagicLevelSource::packValues (float value, float normalizedValue)
+{
+    juce::uint32 valueBits, normalizedBits;
+    std::memcpy (&valueBits, &value, sizeof (float));
+    std::memcpy (&normalizedBits, &normalizedValue, sizeof (float));
+    return (juce::uint64 (valueBits) << 32) | juce::uint64 (normalizedBits);
+}
+
+float MagicLevelSource::unpackValue (juce::uint64 packed)
+{
+    auto bits = juce::uint32 (packed >> 32);
+    float value;
+    std::memcpy (&value, &bits, sizeof (float));
+    return value;
+}
+
+float MagicLevelSource::unpackNormalizedValue (juce::uint64 packed)
+{
+    auto bits = juce::uint32 (packed & 0xffffffff);
+    float value;
+    std::memcpy (&value, &bits, sizeof (float));
+    return value;
 }
 
 void MagicLevelSource::setupSource (int numChannels)
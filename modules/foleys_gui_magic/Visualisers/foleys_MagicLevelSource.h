@@ -39,6 +39,11 @@
 namespace foleys
 {
 
+/**
+ Holds the current value of a meter. setValues() is called from the audio thread,
+ the getters from the GUI. Value and normalized value are published together in a
+ single atomic word, so a reader never sees one without the other.
+ */
 class MagicLevelSource
 {
 public:
@@ -49,13 +54,19 @@ public:
      Send new sample values to the measurement.
      */
     void setValues(float value, float normalizedValue);
-    void resetMaxValue() { _maxRegisteredValue = 0; }
+    void resetMaxValue();
 //    void setMaxEstimatedValue(float value) { _maxEstimatedValue = value; }
 
     float getValue () const;
-    float getNormalizedValue () const { return _normalizedValue; }
+    float getNormalizedValue () const;
     float getMaxValue () const;
 
+    /**
+     Incremented whenever a displayed value changes, so the GUI can skip repainting
+     when nothing happened since the last frame.
+     */
+    juce::uint32 getVersion() const { return _version.load (std::memory_order_acquire); }
+
     void setupSource (int numChannels);
     /**
      Set the number of channels to measure. This should be done on a non-realtime thread.
@@ -68,12 +79,14 @@ public:
 
 private:
     
-    float _value = 0.0;
-    float _normalizedValue = 0.0;
-    float _maxRegisteredValue = 0.0;
+    static juce::uint64 packValues (float value, float normalizedValue);
+    static float unpackValue (juce::uint64 packed);
+    static float unpackNormalizedValue (juce::uint64 packed);
+
+    std::atomic<juce::uint64> _values { 0 };
+    std::atomic<float> _maxRegisteredValue { 0.0f };
+    std::atomic<juce::uint32> _version { 0 };
     int _numChannels = 0;
-    
-    std::vector<float> _valueHistory;
 
     JUCE_DECLARE_WEAK_REFERENCEABLE (MagicLevelSource)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MagicLevelSource)
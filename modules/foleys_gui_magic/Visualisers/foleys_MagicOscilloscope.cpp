@@ -34,20 +34,27 @@
  ==============================================================================
  */
 
-#define PLOT_SIZE 150
 
 namespace foleys
 {
 
 
-MagicOscilloscope::MagicOscilloscope (int channelToDisplay)
-  : channel (channelToDisplay)
+MagicOscilloscope::MagicOscilloscope (int channelToDisplay, double historyLengthToUse)
+  : channel (channelToDisplay),
+    historyLength (historyLengthToUse)
 {
+    fifoBuffer.resize (size_t (fifo.getTotalSize()), 0.0f);
+    resizeHistory (requestedCapacity.load());
 }
+
 void MagicOscilloscope::pushValue(const float value) {
-    if (values.size() == 0) return ;
-    values.erase(values.begin());
-    values.push_back(value);
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+        return; // GUI is not draining, drop the value
+
+    fifoBuffer [size_t (size1 > 0 ? start1 : start2)] = value;
+    fifo.finishedWrite (1);
     resetLastDataFlag();
 }
 
@@ -56,34 +63,153 @@ void MagicOscilloscope::pushSamples (const juce::AudioBuffer<float>& buffer)
     juce::Logger::outputDebugString("Magic Oscilloscope: deprecated pushShamples() called");
 }
 
+void MagicOscilloscope::setHistoryLength (double seconds)
+{
+    historyLength.store (std::max (seconds, 0.0));
+}
+
+void MagicOscilloscope::setHistorySize (int numValues)
+{
+    requestedCapacity.store (std::max (numValues, 2));
+    clearHistory.store (true);
+}
+
+void MagicOscilloscope::prepareToPlay (double sampleRateToUse, int samplesPerBlockExpected)
+{
+    if (sampleRateToUse > 0 && samplesPerBlockExpected > 0)
+    {
+        const auto valuesPerSecond = sampleRateToUse / samplesPerBlockExpected;
+        setHistorySize (juce::roundToInt (historyLength.load() * valuesPerSecond));
+    }
+
+    // the GUI may be painting right now, so let the reader clear its own history
+    resetHistory();
+}
+
+//==============================================================================
+
+void MagicOscilloscope::pullValuesFromFifo()
+{
+    const auto numReady = fifo.getNumReady();
+
+    if (clearHistory.exchange (false))
+    {
+        resizeHistory (requestedCapacity.load());
+        fifo.finishedRead (numReady);
+        return;
+    }
+
+    if (numReady == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+    for (int i = start1; i < start1 + size1; ++i)
+        addToHistory (fifoBuffer [size_t (i)]);
+
+    for (int i = start2; i < start2 + size2; ++i)
+        addToHistory (fifoBuffer [size_t (i)]);
+
+    fifo.finishedRead (size1 + size2);
+}
+
+void MagicOscilloscope::addToHistory (float value)
+{
+    values [size_t (writePosition)] = value;
+    writePosition = (writePosition + 1) % int (values.size());
+
+    addToColumns (numPushed, value);
+    ++numPushed;
+}
+
+void MagicOscilloscope::addToColumns (juce::int64 index, float value)
+{
+    if (columns.empty())
+        return;
+
+    const auto numColumns = juce::int64 (columns.size());
+    const auto column = index * numColumns / juce::int64 (values.size());
+    auto& target = columns [size_t (column % numColumns)];
+
+    if (column != lastColumn)
+    {
+        // a column that falls out of the time span gets reused for the new one
+        target.min = value;
+        target.max = value;
+        lastColumn = column;
+    }
+    else
+    {
+        target.min = std::min (target.min, value);
+        target.max = std::max (target.max, value);
+    }
+}
+
+void MagicOscilloscope::resizeHistory (int capacity)
+{
+    values.assign (size_t (capacity), 0.0f);
+    writePosition = 0;
+    numPushed = 0;
+
+    std::fill (columns.begin(), columns.end(), Column());
+    lastColumn = -1;
+}
+
+void MagicOscilloscope::rebuildColumns (int numColumns)
+{
+    columns.assign (size_t (numColumns), Column());
+    lastColumn = -1;
+
+    const auto capacity = juce::int64 (values.size());
+    const auto first = std::max (juce::int64 (0), numPushed - capacity);
+
+    for (auto index = first; index < numPushed; ++index)
+        addToColumns (index, values [size_t (index % capacity)]);
+}
+
 void MagicOscilloscope::createPlotPaths (juce::Path& path, juce::Path& filledPath, juce::Rectangle<float> bounds, MagicPlotComponent&)
 {
+    const auto numColumns = juce::jlimit (1, int (values.size()), juce::roundToInt (bounds.getWidth()));
+    if (int (columns.size()) != numColumns)
+        rebuildColumns (numColumns);
+
+    pullValuesFromFifo();
 
-    int pos = 0;
-    
     path.clear();
-    path.startNewSubPath (bounds.getX(),
-                          juce::jmap (values [pos], 0.0f, 1.0f, bounds.getBottom(), bounds.getY()));
+    filledPath.clear();
 
-    for (int i = 1; i < values.size(); ++i)
-    {
-        ++pos;
+    // the newest column is drawn on the right edge, columns before the first value are empty
+    const auto columnWidth = bounds.getWidth() / float (std::max (numColumns - 1, 1));
+    const Column empty;
 
-        path.lineTo (juce::jmap (float (i),   0.0f, float (values.size()), bounds.getX(), bounds.getRight()),
-                     juce::jmap (values [pos], 0.0f, 1.0f,                 bounds.getBottom(), bounds.getY()));
+    for (int i = 0; i < numColumns; ++i)
+    {
+        const auto column = lastColumn - numColumns + 1 + i;
+        const auto& c = column < 0 ? empty : columns [size_t (column % numColumns)];
+        const auto x    = bounds.getX() + i * columnWidth;
+        const auto yMax = juce::jmap (c.max, 0.0f, 1.0f, bounds.getBottom(), bounds.getY());
+        const auto yMin = juce::jmap (c.min, 0.0f, 1.0f, bounds.getBottom(), bounds.getY());
+
+        if (i == 0)
+        {
+            path.startNewSubPath (x, yMax);
+            filledPath.startNewSubPath (x, yMax);
+        }
+        else
+        {
+            path.lineTo (x, yMax);
+            filledPath.lineTo (x, yMax);
+        }
+
+        if (c.min != c.max)
+            path.lineTo (x, yMin);
     }
 
-    filledPath = path;
     filledPath.lineTo (bounds.getBottomRight());
     filledPath.lineTo (bounds.getBottomLeft());
     filledPath.closeSubPath();
 }
 
-void MagicOscilloscope::prepareToPlay (double sampleRateToUse, int)
-{
-    values.clear();
-    values.resize(PLOT_SIZE, 0.0);
-}
-
 
 } // namespace foleys
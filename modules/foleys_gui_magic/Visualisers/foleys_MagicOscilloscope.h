@@ -41,7 +41,16 @@ namespace foleys
 
 /**
  This class collects your samples in a circular buffer and allows the GUI to
- draw it in the style of an oscilloscope
+ draw it in the style of an oscilloscope.
+
+ pushValue() writes into a single producer / single consumer FIFO, the GUI drains
+ it into a fixed capacity ring when creating the plot. The audio thread never touches
+ the history and nothing is allocated on it.
+
+ The ring holds historyLength seconds of values at the rate pushValue() is called,
+ i.e. once per block. For drawing, the values are decimated into one min/max pair
+ per pixel column. The columns are updated incrementally as values arrive, so a
+ repaint costs O(width) regardless of the history length.
  */
 class MagicOscilloscope : public MagicPlotSource
 {
@@ -51,8 +60,9 @@ public:
      Create an oscilloscope adapter to push samples into for later display in the GUI.
 
      @param channel lets you select the channel to analyse. -1 means summing all together (the default)
+     @param historyLength the time span of the plot in seconds
      */
-    MagicOscilloscope (int channel=-1);
+    MagicOscilloscope (int channel=-1, double historyLength=2.0);
 
     /**
      Push samples to a buffer to be visualised.
@@ -69,12 +79,57 @@ public:
       */
     void createPlotPaths (juce::Path& path, juce::Path& filledPath, juce::Rectangle<float> bounds, MagicPlotComponent& component) override;
 
+    /**
+     Computes the history capacity from the rate pushValue() will be called at,
+     which is sampleRate / samplesPerBlockExpected.
+     */
     void prepareToPlay (double sampleRate, int samplesPerBlockExpected) override;
 
+    /**
+     Set the time span of the plot in seconds. Takes effect on the next prepareToPlay().
+     */
+    void setHistoryLength (double seconds);
+    double getHistoryLength() const { return historyLength.load(); }
+
+    /**
+     Set the number of values in the history directly, ignoring the time base.
+     */
+    void setHistorySize (int numValues);
+
+    /**
+     Discard the history. Can be called from any thread, the GUI clears it
+     before drawing the next time.
+     */
+    void resetHistory() { clearHistory.store (true); }
+
 private:
+    struct Column
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+
+    void pullValuesFromFifo();
+    void addToHistory (float value);
+    void addToColumns (juce::int64 index, float value);
+    void resizeHistory (int capacity);
+    void rebuildColumns (int numColumns);
+
     int                      channel = -1;
-    
-    std::vector<float> values;
+
+    juce::AbstractFifo       fifo { 1024 };
+    std::vector<float>       fifoBuffer;
+    std::atomic<double>      historyLength { 2.0 };
+    std::atomic<int>         requestedCapacity { 150 };
+    std::atomic<bool>        clearHistory { true };
+
+    /** Only accessed from the GUI thread */
+    std::vector<float>       values;
+    int                      writePosition = 0;
+    juce::int64              numPushed = 0;
+
+    std::vector<Column>      columns;
+    juce::int64              lastColumn = -1;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MagicOscilloscope)
 };
@@ -46,14 +46,24 @@ MagicLevelMeter::MagicLevelMeter()
     setColour (outlineColourId, juce::Colours::silver);
     setColour (tickmarkColourId, juce::Colours::silver);
 
-    startTimerHz (30);
+    refreshScheduler->addClient (this);
 }
 
-std::string to_string_with_precision(const float a_value, const int n = 6) {
-    std::ostringstream out;
-    out.precision(n);
-    out << std::fixed << a_value;
-    return out.str();
+MagicLevelMeter::~MagicLevelMeter()
+{
+    refreshScheduler->removeClient (this);
+}
+
+const juce::String& MagicLevelMeter::CachedText::get (float newValue)
+{
+    // compare at display precision, so jitter below it doesn't cost a new string
+    const auto rounded = std::round (newValue * 100.0f) / 100.0f;
+    if (rounded != value)
+    {
+        value = rounded;
+        text = juce::String (rounded, 2);
+    }
+    return text;
 }
 
 void MagicLevelMeter::paint (juce::Graphics& g)
@@ -106,8 +116,8 @@ void MagicLevelMeter::paint (juce::Graphics& g)
                               static_cast<float>(bar.getX ()), static_cast<float>(bar.getRight ())); ///***remove
      
         g.setColour(juce::Colours::orange);
-        auto valueString = to_string_with_precision(source->getValue(), 2);
-        auto maxValueString = to_string_with_precision(source->getMaxValue(), 2);
+        const auto& valueString = valueText.get (source->getValue());
+        const auto& maxValueString = maxValueText.get (source->getMaxValue());
         g.drawSingleLineText(valueString, 10 + i*width, bar.getBottom (), juce::Justification::left);
         g.setColour(juce::Colours::red);
         g.drawSingleLineText(maxValueString, 10 + i*width, bar.getBottom() - 15, juce::Justification::left);
@@ -119,11 +129,20 @@ void MagicLevelMeter::paint (juce::Graphics& g)
 void MagicLevelMeter::setLevelSource (MagicLevelSource* newSource)
 {
     source = newSource;
+    repaint();
 }
 
-void MagicLevelMeter::timerCallback()
+void MagicLevelMeter::refreshIfNeeded()
 {
-    repaint();
+    if (source == nullptr || ! isShowing())
+        return;
+
+    const auto version = source->getVersion();
+    if (version != lastVersion)
+    {
+        lastVersion = version;
+        repaint();
+    }
 }
 
 } // namespace foleys
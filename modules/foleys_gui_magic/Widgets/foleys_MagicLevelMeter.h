@@ -39,8 +39,12 @@
 namespace foleys
 {
 
+/**
+ Displays a MagicLevelSource. The meters don't run their own timers, they are
+ refreshed by the shared RefreshScheduler and only repaint if the source changed.
+ */
 class MagicLevelMeter : public juce::Component,
-                        private juce::Timer
+                        private RefreshScheduler::Client
 {
 public:
     enum ColourIds
@@ -62,15 +66,31 @@ public:
     };
 
     MagicLevelMeter();
+    ~MagicLevelMeter() override;
 
     void paint (juce::Graphics& g) override;
 
     void setLevelSource (MagicLevelSource* newSource);
 
-    void timerCallback() override;
-
 private:
+    void refreshIfNeeded() override;
+
+    /** Formats the value only if it changed since the last paint */
+    struct CachedText
+    {
+        const juce::String& get (float newValue);
+
+        float value = std::numeric_limits<float>::quiet_NaN();
+        juce::String text;
+    };
+
     juce::WeakReference<MagicLevelSource> source;
+    juce::uint32 lastVersion = 0;
+
+    CachedText valueText;
+    CachedText maxValueText;
+
+    SharedRefreshScheduler refreshScheduler;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MagicLevelMeter)
 };
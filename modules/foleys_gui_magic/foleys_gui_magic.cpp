@@ -44,6 +44,7 @@
 #endif
 
 #include "General/foleys_ApplicationSettings.cpp"
+#include "General/foleys_RefreshScheduler.cpp"
 #include "General/foleys_MagicGUIBuilder.cpp"
 #include "General/foleys_MagicPluginEditor.cpp"
 #include "General/foleys_MagicProcessor.cpp"
@@ -97,6 +97,7 @@
 
 #include "General/foleys_StringDefinitions.h"
 #include "General/foleys_ApplicationSettings.h"
+#include "General/foleys_RefreshScheduler.h"
 #include "General/foleys_SettableProperties.h"
 #include "General/foleys_Resources.h"
 